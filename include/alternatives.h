@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include "pathfinding.h"
+
+// Cost and steepness summary of one route
+struct RouteStats {
+    float cost = 0.0f;       // sum of stored edge costs
+    float length = 0.0f;     // 3D length
+    float climb = 0.0f;      // total height gained
+    float descent = 0.0f;    // total height lost
+    float meanSlope = 0.0f;  // total |rise| over total run
+    float maxSlope = 0.0f;   // steepest single edge
+};
+
+RouteStats routeStats(const std::vector<Node>& graph, const std::vector<int>& path);
+
+struct AlternativeOptions {
+    int maxRoutes = 4;          // including the shortest route
+    float maxStretch = 1.3f;    // reject routes costing more than this times the shortest
+    float maxShare = 0.5f;      // max cost shared with the routes already chosen, times the shortest
+    float minPlateau = 0.1f;    // min plateau cost, times the shortest (local optimality)
+    float corridor = 0.04f;     // an edge counts as shared within this horizontal distance of a chosen route
+};
+
+struct AlternativeRoute {
+    std::vector<int> path;   // start..goal, ready for buildPathVertexData
+    RouteStats stats;
+    float stretch = 1.0f;    // cost relative to the shortest route
+    float shared = 0.0f;     // cost shared with earlier routes, relative to the shortest
+};
+
+// Alternative routes by the via-node / plateau method.
+// A forward tree from the start and a backward tree to the goal are grown to
+// maxStretch times the shortest cost. Any node v then gives the route
+// start -> v -> goal along both trees, at cost dist(start, v) + dist(v, goal).
+// A "plateau" is a chain of arcs on both trees; all its nodes give the same
+// route, and a long plateau means the route is locally optimal rather than a
+// detour around one bad edge. Plateaus are tried cheapest first, keeping
+// routes that are loopless and stay out of the corridor around the routes
+// already chosen. The forward tree is A* with the consistent Euclidean bound
+// and the backward tree uses the exact forward distances as its bound, so
+// together they settle little more than the nodes within the stretch limit.
+// K routes cost about two searches plus O(route length) per candidate, not K
+// searches. Asymmetric costs work: the backward tree follows the reverse arcs,
+// which buildGraph always creates. Both workspaces are kept between queries.
+class AlternativeRouter {
+public:
+    explicit AlternativeRouter(const std::vector<Node>& g);
+
+    // Shortest route first; empty if the goal is unreachable
+    std::vector<AlternativeRoute> find(int startIndex, int goalIndex,
+                                       const AlternativeOptions& options = AlternativeOptions());
+
+    size_t lastSettled() const { return settled; }   // nodes settled by both trees together
+
+private:
+    const std::vector<Node>& graph;
+    SearchWorkspace forward;    // dist from the start, prev = parent towards the start
+    SearchWorkspace backward;   // dist to the goal, prev = next hop towards the goal
+    std::vector<int> forwardOrder;     // nodes in the order the forward tree settled them
+    float hScale;
+    std::vector<uint32_t> onRoute;     // == query stamp: node lies in a chosen route's corridor
+    std::vector<uint32_t> onCandidate; // == candidate stamp: node lies on the route being built
+    uint32_t stamp = 0;
+    size_t settled = 0;
+
+    float arcCost(int from, int to) const;   // cheapest arc from -> to, infinity if none
+    template <class Potential>
+    void grow(SearchWorkspace& ws, int root, int target, bool reverse, float& targetDist, float stretch,
+              Potential potential);
+    void markCorridor(const std::vector<int>& path, float width, uint32_t routeStamp);
+    uint32_t nextStamp();
+};
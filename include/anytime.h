@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "pathfinding.h"
+
+// Anytime Repairing A* (ARA*).
+// Searches with an inflated heuristic weight * h first, so a route is available
+// quickly, then lowers the weight and repairs the previous search instead of
+// restarting: only nodes whose cost improved after they were expanded
+// (INCONS) are re-queued. Every published route comes with a proven bound:
+// its cost is at most bound() times the optimal cost. The weight reaches 1 and
+// the route is optimal if the planner is given enough budget.
+// h is the consistent Euclidean heuristic from heuristicScale.
+class AnytimePathfinder : public SteppableSearch {
+public:
+    AnytimePathfinder(const std::vector<Node>& g, int s, int goal,
+                      float initialWeight = 3.0f, float weightStep = 0.5f);
+    AnytimePathfinder(const AnytimePathfinder&) = delete;
+    AnytimePathfinder& operator=(const AnytimePathfinder&) = delete;
+
+    // One expansion; state.path is set whenever an improved route is published.
+    // Returns false once the optimal route is known.
+    bool step(SearchState& state) override;
+    std::vector<int> currentBestPath(int target) const override;
+    int parentOf(int v) const override { return parent[v]; }
+
+    // Expand until the budget runs out (0 = unlimited) or the search converges.
+    // Returns true if an improved route was published during the call.
+    bool improve(size_t maxExpansions, double maxMs = 0.0);
+
+    const std::vector<int>& bestPath() const { return solution; }  // empty until the first route
+    float bestCost() const { return solutionCost; }
+    float bound() const { return solutionBound; }     // bestCost() <= bound() * optimal
+    float weight() const { return epsilon; }          // weight of the search in progress
+    bool converged() const { return done; }
+    size_t solutionCount() const { return published; } // bumps with every improved route
+    size_t expandedCount() const { return expanded; }
+
+private:
+    const std::vector<Node>& graph;
+    int startIndex, goalIndex;
+    float hScale;
+    float epsilon, epsilonStep;
+
+    std::vector<float> g;
+    std::vector<int> parent;
+    std::vector<uint32_t> closedIn;     // iteration a node was last expanded in
+    std::vector<uint32_t> inconsIn;     // iteration a node was last put in incons
+    std::vector<int> incons;            // expanded this iteration, then improved
+    QuaternaryHeapOpenSet open;
+    uint32_t iteration = 1;
+
+    std::vector<int> solution;
+    float solutionCost;
+    float solutionBound;
+    size_t published = 0;
+    size_t expanded = 0;
+    bool done = false;
+
+    float heuristic(int v) const;
+    bool iterationDone() const;
+    void expand(int u, SearchState* state);
+    bool finishIteration();   // publish, lower the weight and requeue; true if a route was published
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "pathfinding.h"
+
+// Everything a SteppableSearch published since the previous poll
+struct SearchUpdate {
+    std::vector<int> visited;   // new expansions, in order
+    std::vector<int> parents;   // parent of each visited node when it was expanded
+    std::vector<int> frontier;  // frontier of the latest step
+    std::vector<int> bestPath;  // final path, or best path to the latest expansion
+    size_t steps = 0;           // total steps so far
+    bool finished = false;
+};
+
+// Runs a SteppableSearch on a worker thread at full speed.
+// The worker steps in ticks of up to stepsPerTick steps or tickMs milliseconds,
+// then publishes what changed into a pending SearchUpdate under a short lock.
+// poll() swaps that buffer out, so the render thread never waits for a step
+// and its cost per frame doesn't depend on how expensive the search is.
+// The search object must outlive this and must not be touched while it runs.
+class AsyncSearch {
+public:
+    explicit AsyncSearch(SteppableSearch& search, size_t stepsPerTick = 4096, double tickMs = 2.0);
+    ~AsyncSearch();
+    AsyncSearch(const AsyncSearch&) = delete;
+    AsyncSearch& operator=(const AsyncSearch&) = delete;
+
+    // Take everything published since the last call (appended to out.visited);
+    // returns false if nothing new arrived
+    bool poll(SearchUpdate& out);
+
+    bool finished() const { return done.load(std::memory_order_acquire); }
+    void wait();   // block until the search finishes (headless use)
+    void stop();   // abandon the search and join the worker
+
+private:
+    SteppableSearch& search;
+    size_t stepsPerTick;
+    double tickMs;
+
+    std::mutex mutex;
+    SearchUpdate pending;       // guarded by mutex
+    bool hasPending = false;    // guarded by mutex
+
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> done{false};
+    std::thread worker;
+
+    void run();
+};
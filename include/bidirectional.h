@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+#include "pathfinding.h"
+
+// Bidirectional A* between a start and a goal.
+// Both searches use the balanced potential p(v) = (h_goal(v) - h_start(v)) / 2,
+// which is consistent in both directions, so the search can stop as soon as
+// minKey(forward) + minKey(backward) >= best meeting cost and still be optimal.
+class BidirectionalPathfinder : public SteppableSearch {
+public:
+    BidirectionalPathfinder(const std::vector<Node>& g, int s, int goal, float hScale);
+    BidirectionalPathfinder(const std::vector<Node>& g, int s, int goal, float hScale,
+                            SearchWorkspace& forwardWs, SearchWorkspace& backwardWs);
+    BidirectionalPathfinder(const BidirectionalPathfinder&) = delete;
+    BidirectionalPathfinder& operator=(const BidirectionalPathfinder&) = delete;
+
+    bool step(SearchState& state) override;
+    std::vector<int> currentBestPath(int target) const override;
+    int parentOf(int v) const override; // in whichever tree expanded v; backward parents lead to the goal
+
+    // Run to completion and return the path (empty if unreachable)
+    std::vector<int> run();
+
+    float bestCost() const { return mu; }
+    size_t expandedCount() const { return expanded; }
+
+private:
+    const std::vector<Node>& graph;
+    int startIndex, goalIndex;
+    float hScale;
+    SearchWorkspace ownForward, ownBackward; // used when no shared workspaces are given
+    SearchWorkspace* fwd;
+    SearchWorkspace* bwd;
+
+    float mu;           // best start->goal cost seen so far
+    int meetNode = -1;  // node where the best forward/backward paths join
+    bool done = false;
+    size_t expanded = 0;
+
+    void start();
+    float potential(int v) const; // forward potential, backward uses -potential
+    bool finished() const;
+    std::vector<int> joinedPath() const;
+};
+
+// One-shot bidirectional A* (hScale from heuristicScale(graph))
+std::vector<int> findPathBidirectional(const std::vector<Node>& graph, int startIndex, int goalIndex,
+                                       float hScale);
\ No newline at end of file
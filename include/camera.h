@@ -1,12 +1,20 @@
 #pragma once
 #include <glm/glm.hpp>
-#include <GLFW/glfw3.h>
+#include "input.h"
 
-void processInput(GLFWwindow* window, float deltaTime);
-void mouse_callback(GLFWwindow* window, double xpos, double ypos);
-void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+// Free-flying camera: WASD moves, Q/E go down/up, the mouse looks round, the
+// scroll wheel zooms and P prints where it is. Owned by the simulation thread,
+// which hands the matrices to the renderer in each frame packet.
+struct Camera {
+    glm::vec3 position = glm::vec3(0.0f, 1.5f, 3.0f);                    // start slightly above ground, a bit back
+    glm::vec3 front = glm::normalize(glm::vec3(0.0f, -0.3f, -1.0f));     // looking forward and slightly down
+    glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);                          // world up is positive Y
+    float fov = 45.0f;                                                   // field of view (zoom level)
+    float yaw = -90.0f;                                                  // horizontal angle (start facing -Z)
+    float pitch = 0.0f;                                                  // vertical angle (start level)
 
-extern glm::vec3 cameraPos;
-extern glm::vec3 cameraFront;
-extern glm::vec3 cameraUp;
-extern float fov;
\ No newline at end of file
+    void update(const InputState& input, float deltaTime);
+
+    glm::mat4 view() const;
+    glm::mat4 projection(float aspect) const;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "camera.h"
+
+// A scripted camera flight for replays: keyframes of position and look-at target,
+// positions joined by a Catmull-Rom spline and targets interpolated linearly.
+// The same time always gives the same camera, so replays are reproducible.
+class CameraPath {
+public:
+    struct Keyframe {
+        float time;           // seconds, increasing
+        glm::vec3 position;
+        glm::vec3 target;
+    };
+
+    void add(float time, const glm::vec3& position, const glm::vec3& target);
+
+    // Camera at time t (clamped to the path); the path's last keyframe should
+    // repeat its first for a closed loop
+    Camera at(float t) const;
+    float duration() const { return keys.empty() ? 0.0f : keys.back().time; }
+
+    // A closed loop round center in 'seconds': swinging in to half the radius
+    // and back out three times per turn, rising and dipping around 'height'
+    static CameraPath orbit(const glm::vec3& center, float radius, float height, float seconds,
+                            int keyframes = 24);
+
+private:
+    std::vector<Keyframe> keys;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "height_grid.h"
+
+// One iso-height line, stitched across cells and tiles
+struct ContourLine {
+    float level;
+    bool closed;                    // a loop; otherwise both ends lie on the map edge
+    std::vector<glm::vec3> points;
+};
+
+// Contour lines of a height grid by marching squares.
+// Levels are base + k * interval; every 'indexEvery'-th level is drawn darker.
+// Cells are processed in tiles of tileSize x tileSize, in parallel, and each
+// tile keeps its own segments, so editing heights only re-extracts the tiles
+// around the edit. Every strip of 16 cells along a row keeps the height range
+// of its corners, which lets a new interval skip most cells without reading them.
+// A vertex counts as above a level when its height is >= the level; saddle
+// cells are resolved by the mean of their corners.
+class ContourMap {
+public:
+    explicit ContourMap(const HeightGrid& grid, float interval = 0.05f, float base = 0.0f,
+                        int tileSize = 64, int threads = 0);
+
+    // New spacing between levels; regenerates every tile
+    void setInterval(float interval, float base = 0.0f, int indexEvery = 5);
+
+    // Change one vertex height; the tiles touching it are regenerated by update()
+    void setHeight(int vertex, float height);
+    // Regenerate the tiles changed since the last call; returns how many
+    size_t update();
+
+    // GL_LINES vertex data [x y z r g b], as buildPathVertexData emits
+    const std::vector<float>& vertexData();
+    size_t segmentCount() const;
+
+    // Segments joined into polylines (sorted by level); built on demand
+    std::vector<ContourLine> polylines() const;
+
+    const HeightGrid& grid() const { return terrain; }
+    float interval() const { return step; }
+    double lastMs() const { return extractTime; }
+
+private:
+    struct Tile {
+        int i0, j0, i1, j1;               // cell range [i0, i1) x [j0, j1)
+        std::vector<float> data;          // 12 floats per segment
+        std::vector<uint64_t> ends;       // level << 32 | grid edge, two per segment
+        bool dirty = true;
+        bool rangesStale = true;
+    };
+
+    HeightGrid terrain;
+    float step, base;
+    int indexEvery = 5;
+    int tileSize, tilesPerSide, threads;
+    int stripsPerRow;
+    std::vector<float> stripLo, stripHi;  // per 16-cell strip of a row of cells
+    std::vector<float> xs, zs;            // world x of row i, z of column j
+    std::vector<Tile> tiles;
+    std::vector<float> joined;
+    bool joinedStale = true;
+    double extractTime = 0.0;
+
+    float level(int k) const { return base + k * step; }
+    int firstLevelAbove(float h) const;   // smallest k with level(k) > h
+    void refreshRanges(Tile& tile);
+    void extractTile(Tile& tile);
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include "pathfinding.h"
+
+// Preprocessing report for ContractionHierarchy
+struct ContractionStats {
+    double preprocessMs = 0.0;
+    size_t originalEdges = 0;   // undirected edges after removing duplicates
+    size_t shortcuts = 0;       // shortcut edges added during contraction
+    size_t upwardEdges = 0;     // edges kept in the search graph
+    size_t rounds = 0;          // independent sets contracted
+};
+
+// Contraction hierarchy over the (static, undirected) terrain graph.
+// Nodes are ordered by edge difference and contracted in rounds of
+// independent local minima, whose hop- and settle-limited witness searches run
+// in parallel; shortcut edges are added where no witness path is found.
+// Queries are a bidirectional Dijkstra over upward edges only, with stall on
+// demand, and shortcuts are unpacked back into original graph nodes, so
+// results can go to buildPathVertexData.
+// The graph must not change after construction; rebuild if it does.
+class ContractionHierarchy {
+public:
+    explicit ContractionHierarchy(const std::vector<Node>& g, int threads = 0);
+
+    // Exact shortest path; empty if unreachable, or if a shortcut fails to unpack
+    // (a broken hierarchy). cost (optional) receives its length, infinity then.
+    std::vector<int> findPath(int start, int goal, float* cost = nullptr);
+
+    const ContractionStats& stats() const { return report; }
+    size_t lastSettled() const { return settled; } // nodes settled by the last query
+
+private:
+    struct ChEdge {
+        int to;
+        float cost;
+        int middle;   // contracted node this shortcut skips, -1 for an original edge
+    };
+
+    const std::vector<Node>& graph;
+    std::vector<int> rank;
+    std::vector<std::vector<ChEdge>> up;  // edges to higher-ranked nodes
+    ContractionStats report;
+
+    SearchWorkspace forward, backward;
+    size_t settled = 0;
+
+    void contract(int threads);
+    bool unpack(int a, int b, std::vector<int>& out) const; // false if an up-edge is missing
+};
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/glm.hpp>
+
+// Edge cost policies for buildGraph / findPathModel / ModelPathfinder.
+// A policy is a small value type with two inline members:
+//   float operator()(from, to)   cost of the edge from -> to
+//   float lowerBound(from, goal) admissible, consistent estimate of the cost
+//                                of any route from `from` to `goal`
+// Searches take the policy as a template parameter, so both calls inline into
+// the inner loop (no virtual or std::function dispatch per edge).
+// Positions are in terrain units (the map spans [-1, 1] in x and z).
+
+inline float horizontalDistance(const glm::vec3& a, const glm::vec3& b) {
+    return glm::length(glm::vec2(b.x - a.x, b.z - a.z));
+}
+
+// Rise over run between two vertices (unsigned); 0 for a vertical step
+inline float slopeBetween(const glm::vec3& a, const glm::vec3& b) {
+    float run = horizontalDistance(a, b);
+    return run > 0.0f ? std::abs(b.y - a.y) / run : 0.0f;
+}
+
+// Bounds are shaved slightly so float rounding can't make them inconsistent
+constexpr float BOUND_SHAVE = 0.999f;
+
+// 1 + penalty * slope per edge (the original model; cost ~ edges walked)
+struct SlopeCost {
+    float penalty = 2.0f;
+    // Longest horizontal edge in the graph; the bound divides by it.
+    // Infinity (the default) makes lowerBound 0, which is always safe.
+    float maxStep = std::numeric_limits<float>::infinity();
+
+    static constexpr bool symmetric = true;
+
+    float operator()(const glm::vec3& a, const glm::vec3& b) const {
+        return 1.0f + slopeBetween(a, b) * penalty;
+    }
+
+    // Every edge costs at least (run + penalty * |rise|) / maxStep
+    float lowerBound(const glm::vec3& a, const glm::vec3& goal) const {
+        return BOUND_SHAVE * (horizontalDistance(a, goal) + penalty * std::abs(goal.y - a.y)) / maxStep;
+    }
+};
+
+// Tobler's hiking function: walking time in hours,
+// speed = 6 * exp(-3.5 * |slope + 0.05|) km/h, fastest on a gentle descent
+struct ToblerCost {
+    float unitKm = 5.0f;   // kilometres per terrain unit
+
+    static constexpr bool symmetric = false;
+
+    float operator()(const glm::vec3& a, const glm::vec3& b) const {
+        float run = horizontalDistance(a, b);
+        float grade = run > 0.0f ? (b.y - a.y) / run : 0.0f;
+        float kmh = 6.0f * std::exp(-3.5f * std::abs(grade + 0.05f));
+        return glm::length(b - a) * unitKm / kmh;
+    }
+
+    // Straight line at the top speed of 6 km/h
+    float lowerBound(const glm::vec3& a, const glm::vec3& goal) const {
+        return BOUND_SHAVE * glm::length(goal - a) * unitKm / 6.0f;
+    }
+};
+
+// Work-like cost: horizontal distance plus weighted climb and descent
+struct EnergyCost {
+    float climb = 8.0f;     // cost per unit of height gained
+    float descent = 0.0f;   // cost per unit of height lost
+
+    static constexpr bool symmetric = false;
+
+    float operator()(const glm::vec3& a, const glm::vec3& b) const {
+        float rise = b.y - a.y;
+        return horizontalDistance(a, b) + climb * std::max(rise, 0.0f) + descent * std::max(-rise, 0.0f);
+    }
+
+    // Each term is subadditive along a route, so the straight-line version is a bound
+    float lowerBound(const glm::vec3& a, const glm::vec3& goal) const {
+        float rise = goal.y - a.y;
+        return BOUND_SHAVE * (horizontalDistance(a, goal) + climb * std::max(rise, 0.0f) +
+                              descent * std::max(-rise, 0.0f));
+    }
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include "pathfinding.h"
+
+// Report for the last DeltaStepping::distances call
+struct DeltaSteppingStats {
+    double ms = 0.0;
+    size_t buckets = 0;       // non-empty buckets processed
+    size_t phases = 0;        // synchronised relaxation rounds (light + heavy)
+    size_t relaxations = 0;   // requests generated
+};
+
+// Parallel delta-stepping single-source shortest paths.
+// Tentative distances are bucketed by floor(d / delta). Each bucket is emptied
+// in rounds that relax its light edges (cost <= delta) until no node re-enters
+// it, then its heavy edges are relaxed once. Every node is owned by one worker
+// (by 64-node blocks); workers write relaxation requests into per-owner buffers,
+// and each owner applies its own, so distances need no atomics or locks.
+// Results are identical to shortestDistances (same float sums, same minimum).
+class DeltaStepping {
+public:
+    // delta <= 0 picks suggestDelta(g)
+    explicit DeltaStepping(const std::vector<Node>& g, float delta = 0.0f, int threads = 0);
+
+    std::vector<float> distances(int source);
+
+    float delta() const { return bucketWidth; }
+    int threadCount() const { return threads; }
+    const DeltaSteppingStats& lastStats() const { return report; }
+
+    // 90th percentile of the edge costs: nearly every edge is light, and a
+    // bucket still spans several hops so each round has work to share
+    static float suggestDelta(const std::vector<Node>& g);
+
+private:
+    // Duplicate-free CSR adjacency, light arcs first in each row
+    std::vector<size_t> rowStart;
+    std::vector<size_t> lightEnd;
+    std::vector<int> target;
+    std::vector<float> weight;
+
+    float bucketWidth;
+    int threads;
+    DeltaSteppingStats report;
+};
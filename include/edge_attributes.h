@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include "pathfinding.h"
+
+// Runtime cost profile (hiker, runner, pack animal, ...), evaluated per arc as
+//   base + perLength * run
+//   + uphill * grade_up + downhill * grade_down     (grade = rise / run)
+//   + climb * rise_up + descent * rise_down
+//   + channel * run * wetness                       (see EdgeAttributes::setWetness)
+// and infinity where |grade| > maxGrade. The default profile reproduces
+// edgeCost (1 + 2 * slope) bit for bit.
+struct CostProfile {
+    float base = 1.0f;
+    float perLength = 0.0f;
+    float uphill = 2.0f;
+    float downhill = 2.0f;
+    float climb = 0.0f;
+    float descent = 0.0f;
+    float maxGrade = std::numeric_limits<float>::infinity();
+    float channel = 0.0f;   // e.g. to keep routes out of drainage channels
+};
+
+// Geometric attributes of every arc, stored once as structure-of-arrays in
+// graph order: arc offsets()[u] + k is graph[u].neighbors[k]. Profiles are
+// evaluated from these into plain cost arrays (one float per arc), so
+// switching profile is a linear pass instead of a graph rebuild.
+class EdgeAttributes {
+public:
+    explicit EdgeAttributes(const std::vector<Node>& g, int threads = 0);
+
+    size_t arcCount() const { return run.size(); }
+    size_t arcIndex(int u, const Edge& e) const { return first[u] + (&e - graph[u].neighbors.data()); }
+    const std::vector<size_t>& offsets() const { return first; }
+    float maxStep() const { return longest; }   // longest horizontal arc
+
+    // Per-vertex wetness in [0, 1] (e.g. channelStrength from hydrology.h) for the
+    // channel term; each arc takes the wetter of its ends
+    void setWetness(const std::vector<float>& perVertex);
+
+    // Evaluate one profile into costs (resized to arcCount())
+    void evaluate(const CostProfile& profile, std::vector<float>& costs) const;
+    // Evaluate several profiles in one sweep over the attributes
+    void evaluate(const std::vector<CostProfile>& profiles, std::vector<std::vector<float>>& costs) const;
+
+    // Consistent lower bound on the profile cost from a to goal
+    float lowerBound(const CostProfile& profile, const glm::vec3& a, const glm::vec3& goal) const;
+
+private:
+    const std::vector<Node>& graph;
+    std::vector<size_t> first;   // node -> first arc, plus a final end entry
+    std::vector<float> run;      // horizontal length per arc
+    std::vector<float> rise;     // signed height change per arc
+    std::vector<float> wet;      // run * wetness per arc; empty until setWetness
+    std::vector<size_t> verticalArcs;   // arcs with no horizontal run (none on a height grid)
+    float longest = 0.0f;
+    int threads;
+
+    void evaluateRange(const CostProfile& profile, size_t begin, size_t end, float* out) const;
+};
+
+// Copy a cost array into Edge::cost so the searches that read stored costs use the profile
+void applyCosts(std::vector<Node>& graph, const EdgeAttributes& attributes, const std::vector<float>& costs);
+
+// Optimal A* over a profile's cost array with the profile's lower bound
+std::vector<int> findPathProfile(const std::vector<Node>& graph, const EdgeAttributes& attributes,
+                                 const CostProfile& profile, const std::vector<float>& costs,
+                                 int startIndex, int goalIndex, SearchWorkspace& ws);
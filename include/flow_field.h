@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include "pathfinding.h"
+
+// Shortest-path tree towards one goal (a "flow field").
+// Built by a single Dijkstra from the goal; the graph is undirected with
+// symmetric costs, so that equals a reverse search. Afterwards every node knows
+// its exact cost to the goal and the next node on an optimal route there,
+// so any start's route is a walk along nextHop in O(path length).
+// Rebuild when edge costs change.
+class FlowField {
+public:
+    FlowField(const std::vector<Node>& g, int goal);
+
+    int goal() const { return goalIndex; }
+    float costToGoal(int v) const { return cost[v]; }   // infinity if unreachable
+    int nextHop(int v) const { return next[v]; }         // -1 at the goal or if unreachable
+
+    // Route from start to the goal (empty if unreachable)
+    std::vector<int> routeFrom(int start) const;
+
+    float maxCost() const { return farthest; }  // largest finite cost-to-goal
+    double buildMs() const { return buildTime; }
+
+private:
+    int goalIndex;
+    std::vector<float> cost;
+    std::vector<int> next;
+    float farthest = 0.0f;
+    double buildTime = 0.0;
+};
+
+// Point vertex data [x y z r g b], one per node, coloured from blue (near the
+// goal) to red (far); unreachable nodes are skipped
+std::vector<float> buildHeatmapVertexData(const std::vector<Node>& graph, const FlowField& field);
@@ -0,0 +1,52 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+
+// CPU and GPU time of each frame. begin()/end() bracket the frame's GL commands
+// on the render thread: the CPU side is the wall time between them, the GPU
+// side a GL_TIME_ELAPSED query around the same commands. Queries rotate through
+// a ring and each is read 'latency' frames later, by which time the GPU has
+// normally finished it, so measuring doesn't stall the pipeline.
+// Drivers that defer all work to a flush (Mesa's llvmpipe) report next to no
+// GPU time; a synced end() also waits for the frame with glFinish and records
+// begin-to-done wall time, which holds on any driver.
+class FrameTimer {
+public:
+    struct Summary {
+        size_t frames = 0;
+        double meanMs = 0.0, p50Ms = 0.0, p90Ms = 0.0, p99Ms = 0.0, maxMs = 0.0;
+    };
+
+    explicit FrameTimer(int latency = 4);
+    ~FrameTimer() { release(); }
+    FrameTimer(const FrameTimer&) = delete;
+    FrameTimer& operator=(const FrameTimer&) = delete;
+
+    void begin();
+    void end(bool record = true, bool sync = false);   // record = false for warm-up frames
+    void finish();                  // wait for the queries still in flight
+
+    Summary cpu() const { return summarize(cpuMs); }
+    Summary gpu() const { return summarize(gpuMs); }
+    Summary synced() const { return summarize(syncedMs); }
+    const std::vector<double>& cpuTimes() const { return cpuMs; }
+    const std::vector<double>& gpuTimes() const { return gpuMs; }
+
+    void release();   // delete the queries (before the context goes away)
+
+private:
+    struct Slot {
+        GLuint query = 0;
+        bool pending = false;
+        bool record = false;
+    };
+    std::vector<Slot> slots;
+    size_t frame = 0;
+    std::chrono::steady_clock::time_point started;
+    std::vector<double> cpuMs, gpuMs, syncedMs;
+
+    void collect(Slot& slot);
+    static Summary summarize(std::vector<double> times);
+};
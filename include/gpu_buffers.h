@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <glad/glad.h>
+
+// A GL buffer that is only written at its end, for data that grows frame by
+// frame (search expansions, a path being extended). append() uploads just the
+// new bytes with glBufferSubData; when the storage is full it doubles and the
+// old contents are copied on the GPU, under the same buffer name, so VAOs that
+// reference it stay valid. Upload cost is proportional to what was appended.
+// Writes go through GL_COPY_WRITE_BUFFER, so the current VAO's element buffer
+// binding is never disturbed. Needs a current GL context from construction to release().
+class AppendBuffer {
+public:
+    explicit AppendBuffer(size_t initialBytes = 4096);
+    ~AppendBuffer() { release(); }
+    AppendBuffer(const AppendBuffer&) = delete;
+    AppendBuffer& operator=(const AppendBuffer&) = delete;
+
+    void append(const void* data, size_t bytes);
+    // Drop everything from offset on; later appends overwrite it
+    void truncate(size_t offset) { if (offset < used) used = offset; }
+    void clear() { used = 0; }
+    void release();   // delete the GL buffer (before the context goes away)
+
+    GLuint id() const { return buffer; }
+    size_t size() const { return used; }
+
+private:
+    GLuint buffer = 0;
+    size_t capacity;
+    size_t used = 0;
+
+    void reserve(size_t bytes);
+};
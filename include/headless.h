@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+struct GLFWwindow;
+
+// Command line of the headless benchmark:
+//   PeakGen --headless [--frames N] [--warmup N] [--size WxH] [--grid N] [--seed S]
+//                      [--dump DIR] [--dump-every K]
+// It replays a fixed camera flight over a fixed-seed terrain offscreen and prints
+// CPU and GPU frame-time percentiles; --dump writes every K-th frame as a PPM.
+struct HeadlessOptions {
+    bool enabled = false;
+    int frames = 600;          // measured frames, at a fixed 60 fps step
+    int warmup = 30;           // frames drawn first and not measured
+    int width = 1280, height = 720;
+    int grid = 30;             // cells per side, as generateTerrain takes it
+    uint32_t seed = 1337;
+    std::string dumpDir;       // empty: no dumps
+    int dumpEvery = 60;
+
+    // false (after printing the usage) on an argument it doesn't understand
+    bool parse(int argc, char** argv);
+};
+
+// An offscreen GL 3.3 core context with a framebuffer object of the requested
+// size to draw into. Built with EGL (PEAKGEN_HAS_EGL) it is surfaceless, via
+// EGL_MESA_platform_surfaceless, so it needs no display server or GPU: Mesa's
+// software rasteriser draws. Otherwise, or if that fails, a hidden GLFW window
+// provides the context.
+class OffscreenContext {
+public:
+    ~OffscreenContext() { release(); }
+
+    // Make a context current on this thread; load GL with loader() next
+    bool create(int width, int height);
+    GLADloadproc loader() const;
+    // After GL is loaded: the framebuffer (RGBA8 colour, 24-bit depth)
+    bool createFramebuffer();
+    void bind() const;   // the framebuffer and its viewport
+
+    // The frame as RGB rows, top row first
+    void readPixels(std::vector<uint8_t>& rgb) const;
+
+    int width() const { return w; }
+    int height() const { return h; }
+    const std::string& description() const { return api; }
+
+    void release();   // framebuffer and context
+
+private:
+    int w = 0, h = 0;
+    std::string api;
+    GLuint framebuffer = 0, colorBuffer = 0, depthBuffer = 0;
+    void* display = nullptr;      // EGLDisplay
+    void* context = nullptr;      // EGLContext
+    GLFWwindow* window = nullptr;
+
+    bool createEGL();
+};
+
+// Binary PPM (P6) of RGB rows, top row first
+bool writePPM(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb);
@@ -0,0 +1,36 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Terrain heights as a regular side x side grid, as generateTerrain lays them
+// out: vertex i * side + j is at x = origin.x + i * spacing, z = origin.y + j * spacing.
+struct HeightGrid {
+    int side = 0;
+    float spacing = 1.0f;       // distance between neighbouring vertices
+    glm::vec2 origin{0.0f};     // x, z of vertex 0
+    std::vector<float> heights;
+
+    HeightGrid() = default;
+
+    // positions must be the full terrain grid; side is taken from its size
+    explicit HeightGrid(const std::vector<glm::vec3>& positions) {
+        side = static_cast<int>(std::lround(std::sqrt(static_cast<double>(positions.size()))));
+        heights.resize(positions.size());
+        for (size_t v = 0; v < positions.size(); ++v) heights[v] = positions[v].y;
+        if (side > 1) {
+            origin = glm::vec2(positions[0].x, positions[0].z);
+            spacing = positions[side].x - positions[0].x;
+        }
+    }
+
+    size_t size() const { return heights.size(); }
+
+    // Vertex nearest to (x, z), clamped to the grid
+    int nearestVertex(float x, float z) const {
+        int i = std::clamp(static_cast<int>(std::lround((x - origin.x) / spacing)), 0, side - 1);
+        int j = std::clamp(static_cast<int>(std::lround((z - origin.y) / spacing)), 0, side - 1);
+        return i * side + j;
+    }
+};
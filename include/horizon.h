@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "height_grid.h"
+
+// Baked horizon angles for terrain shadows and ambient occlusion.
+// For each vertex and each of 16 azimuths, the elevation angle of the highest
+// terrain seen in that direction. The azimuths are the grid steps (1,0), (2,1),
+// (1,1), (1,2), (0,1), ... and their opposites, so every sight line runs through
+// grid vertices and the horizon is exact along it: each line is swept once in
+// each direction, keeping the upper convex hull of the terrain already passed,
+// whose tangent from the next vertex is its horizon. O(1) amortised per vertex
+// and direction; lines are independent and run in parallel.
+//
+// A shader lights a vertex from the sun by comparing the sun's elevation with
+// the horizon in its direction (blended between the two nearest azimuths), and
+// dims ambient light by the open sky fraction.
+class HorizonMap {
+public:
+    static const int DIRECTIONS = 16;
+
+    explicit HorizonMap(const HeightGrid& grid, int threads = 0);
+
+    // Recompute for new heights (same or different grid size)
+    void bake(const HeightGrid& grid);
+
+    // DIRECTIONS bytes per vertex, direction d at [vertex * DIRECTIONS + d]:
+    // the horizon elevation, clamped at 0, as angle / (pi/2) * 255. Ready to
+    // upload as four normalised vec4 vertex attributes.
+    const std::vector<uint8_t>& angles() const { return horizon; }
+    // Cosine-weighted open sky per vertex: 1 - mean over directions of sin^2(horizon), 255 = open
+    const std::vector<uint8_t>& skyView() const { return sky; }
+
+    float horizonAngle(int vertex, int direction) const;   // radians
+    double lastMs() const { return bakeTime; }
+
+    // Grid step (di, dj) of azimuth d, and the same as a unit world (x, z) direction
+    static glm::ivec2 gridStep(int d);
+    static glm::vec2 direction(int d);
+    // Per-direction weights that blend the horizon towards toSun: the two azimuths
+    // on either side of it, by angle. Upload as four vec4s to dot with the attributes.
+    static void sunWeights(const glm::vec3& toSun, float weights[DIRECTIONS]);
+
+private:
+    std::vector<uint8_t> horizon;
+    std::vector<uint8_t> sky;
+    int threads;
+    double bakeTime = 0.0;
+};
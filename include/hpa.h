@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+#include "pathfinding.h"
+
+// Query statistics for HierarchicalPathfinder::findPath
+struct HpaQueryStats {
+    size_t abstractExpanded = 0;  // nodes expanded in the abstract graph
+    size_t refineExpanded = 0;    // nodes expanded while refining segments
+    float abstractCost = 0.0f;    // cost of the abstract route
+    float cost = 0.0f;            // cost of the refined full-resolution path
+};
+
+// HPA*-style hierarchical pathfinding over the row-major terrain grid.
+// The grid is split into clusterSize x clusterSize clusters. Edges that cross
+// a cluster border give transition nodes; each cluster stores the cheapest
+// in-cluster cost between its transitions. Queries search that small
+// abstract graph and then refine each abstract hop inside its own cluster.
+//
+// Paths are near-optimal, not optimal: they may only cross borders at
+// transitions. Compare HpaQueryStats::cost against a flat search to measure it.
+class HierarchicalPathfinder {
+public:
+    // side = vertices per grid row (N + 1 for generateTerrain(N, ...))
+    // transitionSpacing = border vertices between consecutive transitions
+    HierarchicalPathfinder(const std::vector<Node>& g, int side, int clusterSize = 32,
+                           int transitionSpacing = 8, int threads = 0);
+
+    // Recompute one cluster after the costs of edges touching it changed
+    void updateCluster(int cluster);
+
+    std::vector<int> findPath(int start, int goal, HpaQueryStats* stats = nullptr);
+
+    int clusterOf(int node) const;
+    int clusterCount() const { return clustersPerSide * clustersPerSide; }
+    size_t abstractNodeCount() const { return abstractNodes.size(); }
+    size_t abstractEdgeCount() const;
+
+private:
+    struct InterEdge {
+        int to;      // abstract node in the neighbouring cluster
+        float cost;
+    };
+    struct AbstractNode {
+        int node;     // graph node index
+        int cluster;
+        int slot;     // row in the cluster's cost table
+        std::vector<InterEdge> inter;
+    };
+    struct Cluster {
+        int row0, col0, rows, cols;
+        std::vector<int> transitions;  // abstract node ids
+        std::vector<float> costs;      // transitions x transitions in-cluster costs
+    };
+
+    const std::vector<Node>& graph;
+    int side, clusterSize, clustersPerSide;
+    float hScale;
+
+    std::vector<Cluster> clusters;
+    std::vector<AbstractNode> abstractNodes;
+    std::vector<int> abstractOf;   // graph node -> abstract id or -1
+
+    SearchWorkspace querySearch;   // in-cluster searches use local indices
+    SearchWorkspace abstractWs;
+
+    void buildTransitions(int transitionSpacing);
+    void computeCluster(int cluster, SearchWorkspace& scratch);
+    void refreshInterCosts(int cluster);
+
+    int localIndex(const Cluster& c, int node) const;
+    int globalIndex(const Cluster& c, int local) const;
+
+    // Search within one cluster from source; stops early once goal (if any) is closed
+    void searchCluster(const Cluster& c, int source, int goal, SearchWorkspace& scratch, size_t* expanded) const;
+    std::vector<int> refineSegment(int from, int to, size_t* expanded);
+};
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "height_grid.h"
+
+// Drainage network of a height grid (see hydrology.cpp)
+struct DrainageNetwork {
+    std::vector<float> filled;           // heights with every depression filled to its spill level
+    std::vector<int> downstream;         // D8 receiver per vertex, -1 where water leaves the map
+    std::vector<uint32_t> accumulation;  // vertices draining through each vertex, itself included
+    double fillMs = 0.0, directionMs = 0.0, accumulationMs = 0.0;
+};
+
+// Priority-flood depression filling (Barnes et al. 2014, with the pit queue):
+// the map edge is flooded inwards lowest first, and any cell reached from a
+// higher one is raised to it. Cells rising away from a drained one are traced
+// uphill without the priority queue (Zhou et al. 2016), so only cells bordering
+// lower unvisited ground are queued. O(N) inside pits and along slopes.
+std::vector<float> fillDepressions(const HeightGrid& grid);
+
+// Same result, by tiles in parallel (Barnes 2016). Each tile is flooded from its
+// own border, labelling which border cell every cell drains to and the lowest
+// contact height between labels. A small graph of labels is then solved for the
+// level each one must reach to spill off the map, and every cell is raised to
+// its label's level.
+std::vector<float> fillDepressionsTiled(const HeightGrid& grid, int tileSize = 256, int threads = 0);
+
+// Steepest-descent (D8) receiver on a filled surface. Flats drain towards their
+// outlet along a breadth-first search; map edge vertices are outlets.
+std::vector<int> flowDirections(const HeightGrid& grid, const std::vector<float>& filled, int threads = 0);
+
+// Upstream area in vertices, by passing counts down the receivers in topological order
+std::vector<uint32_t> flowAccumulation(const std::vector<int>& downstream, int threads = 0);
+
+// Fill, directions and accumulation; tileSize > 0 uses the tiled fill
+DrainageNetwork analyzeDrainage(const HeightGrid& grid, int tileSize = 0, int threads = 0);
+
+// Channel strength per vertex in [0, 1]: 0 below minArea upstream vertices,
+// log-scaled to 1 at the largest river. Usable as a shader attribute or as the
+// wetness of EdgeAttributes::setWetness.
+std::vector<float> channelStrength(const std::vector<uint32_t>& accumulation, uint32_t minArea);
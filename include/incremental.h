@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include "pathfinding.h"
+
+// Lifelong Planning A* (LPA*) between a fixed start and goal.
+// g/rhs values survive edge cost changes: after the graph is edited, pass the
+// changed arcs to edgesChanged() and the next steps only repair the nodes whose
+// cost-from-start actually moved, instead of searching from scratch.
+//
+// The graph must stay undirected with symmetric costs (buildGraph and
+// setNodeHeight keep it that way), and only edge costs may change.
+// The heuristic is horizontal distance / longest horizontal edge, which stays
+// admissible whatever the heights become because edgeCost never drops below 1.
+class IncrementalPathfinder : public SteppableSearch {
+public:
+    IncrementalPathfinder(const std::vector<Node>& g, int s, int goal);
+    IncrementalPathfinder(const IncrementalPathfinder&) = delete;
+    IncrementalPathfinder& operator=(const IncrementalPathfinder&) = delete;
+
+    // One queue pop; returns false (and fills state.path) once the goal is consistent
+    bool step(SearchState& state) override;
+    std::vector<int> currentBestPath(int target) const override;
+    int parentOf(int v) const override;
+
+    // Step until the goal is consistent and return the path (empty if unreachable)
+    std::vector<int> run();
+
+    // Arcs whose cost in the graph changed since the last call
+    void edgesChanged(const std::vector<EdgeChange>& changes);
+
+    float cost() const { return g[goalIndex]; }
+    size_t expandedCount() const { return expanded; } // pops since construction
+
+private:
+    struct Key {
+        float primary;    // min(g, rhs) + h
+        float secondary;  // min(g, rhs)
+        bool operator<(const Key& o) const {
+            return primary < o.primary || (primary == o.primary && secondary < o.secondary);
+        }
+    };
+
+    // Indexed binary heap keyed by Key; LPA* needs arbitrary updates and removals
+    class Queue {
+    public:
+        void init(size_t nodeCount) { pos.assign(nodeCount, -1); }
+        bool empty() const { return heap.empty(); }
+        bool contains(int v) const { return pos[v] >= 0; }
+        const Key& topKey() const { return heap[0].key; }
+        int top() const { return heap[0].idx; }
+        void set(int v, Key key);   // insert or update
+        void remove(int v);
+
+    private:
+        struct Entry {
+            int idx;
+            Key key;
+        };
+        std::vector<Entry> heap;
+        std::vector<int> pos;
+        void moveTo(int i, const Entry& e) { heap[i] = e; pos[e.idx] = i; }
+        void siftUp(int i);
+        void siftDown(int i);
+    };
+
+    const std::vector<Node>& graph;
+    int startIndex, goalIndex;
+    float hScale;
+
+    std::vector<float> g, rhs;
+    Queue open;
+    size_t expanded = 0;
+
+    float heuristic(int v) const;
+    Key keyOf(int v) const;
+    bool finished() const;
+    void updateVertex(int v, std::vector<int>* frontier);
+    void expand(std::vector<int>* visited, std::vector<int>* frontier);
+};
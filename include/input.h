@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <glm/glm.hpp>
+#include <GLFW/glfw3.h>
+
+// Keyboard and mouse since the previous take(), for a thread that can't call GLFW
+struct InputState {
+    std::array<bool, GLFW_KEY_LAST + 1> down{};         // held at the time of the take
+    std::array<uint8_t, GLFW_KEY_LAST + 1> presses{};   // times pressed since the last take
+    glm::vec2 look = glm::vec2(0.0f);                   // cursor movement (x right, y up)
+    float scroll = 0.0f;
+
+    bool held(int key) const { return down[key]; }
+    // An odd number of presses flips a toggle
+    bool toggled(int key) const { return presses[key] & 1; }
+    bool pressed(int key) const { return presses[key] > 0; }
+};
+
+// GLFW only reports input on the main thread, in its callbacks; they record it
+// here and the simulation thread takes it, so input is never missed between its ticks.
+// Install with install(window); the window's user pointer is set to this.
+class InputQueue {
+public:
+    void install(GLFWwindow* window);
+
+    void key(int key, int action);
+    void cursor(double x, double y);
+    void scroll(double dy);
+
+    InputState take();   // everything since the last take; presses, look and scroll restart at 0
+
+private:
+    std::mutex mutex;
+    InputState state;
+    double lastX = 0.0, lastY = 0.0;
+    bool firstCursor = true;   // no movement on the first event, so the view doesn't jump
+};
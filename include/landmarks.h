@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "pathfinding.h"
+
+// Landmark distance tables for the ALT heuristic (A*, Landmarks, Triangle inequality).
+// For every landmark L the exact cost d(L, v) to every node is stored, and
+// |d(L, goal) - d(L, v)| is a lower bound on d(v, goal). The maximum over all
+// landmarks is admissible and consistent, so A* with it (weight 1) is optimal.
+class LandmarkTable {
+public:
+    // Picks `count` landmarks by farthest-point selection and builds their
+    // tables, one Dijkstra per landmark in parallel
+    LandmarkTable(const std::vector<Node>& g, int count = 8, int threads = 0);
+
+    float lowerBound(int v, int goal) const {
+        const float* dv = &dist[static_cast<size_t>(v) * count];
+        const float* dg = &dist[static_cast<size_t>(goal) * count];
+        float best = 0.0f;
+        for (int l = 0; l < count; ++l) best = std::max(best, std::abs(dg[l] - dv[l]));
+        return best;
+    }
+
+    const std::vector<int>& landmarks() const { return chosen; }
+    double buildMs() const { return buildTime; }
+
+private:
+    int count;
+    std::vector<int> chosen;
+    std::vector<float> dist;   // node-major: dist[v * count + l]
+    double buildTime = 0.0;
+};
+
+// One-shot optimal A* guided by the landmark bound
+std::vector<int> findPathALT(const std::vector<Node>& graph, const LandmarkTable& landmarks,
+                             int startIndex, int goalIndex, SearchWorkspace& ws);
\ No newline at end of file
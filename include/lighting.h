@@ -1,6 +1,9 @@
 #pragma once
 #include <glm/glm.hpp>
+#include "shader.h"
 
-void setLightUniforms(unsigned int shaderProgram,
-                      const glm::vec3& lightPos,
-                      const glm::vec3& viewPos);
\ No newline at end of file
+// Lighting part of the per-frame uniforms: light direction, sun elevation and
+// the horizon-map blend for a sun in direction toSun (unit), plus the eye position
+void setLightUniforms(FrameUniforms& frame,
+                      const glm::vec3& toSun,
+                      const glm::vec3& viewPos);
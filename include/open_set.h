@@ -0,0 +1,239 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// Open-set policies for the A* searches.
+// All of them share the same interface:
+//   reset(nodeCount)   start a new query
+//   push(idx, key)     insert idx, or lower its key if already queued
+//   pop()              remove and return the index with the smallest key
+//   minKey()           smallest key currently queued
+// Policies that keep lazy duplicates may return a node more than once,
+// so callers still skip nodes that are already closed.
+
+// Operation counters shared by every policy (used by the benchmark)
+struct OpenSetStats {
+    size_t pushes = 0;      // new entries inserted
+    size_t decreases = 0;   // in-place key decreases
+    size_t pops = 0;
+    size_t peakSize = 0;    // largest number of queued entries
+    size_t peakBytes = 0;   // memory held by the queue at its peak
+};
+
+// std::priority_queue with lazy duplicates (the original behaviour)
+class BinaryHeapOpenSet {
+public:
+    void reset(size_t) { heap = {}; }
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    float minKey() const { return heap.top().key; }
+
+    void push(int idx, float key) {
+        heap.push({idx, key});
+        ++stats.pushes;
+        if (heap.size() > stats.peakSize) {
+            stats.peakSize = heap.size();
+            stats.peakBytes = heap.size() * sizeof(Entry);
+        }
+    }
+
+    int pop() {
+        int idx = heap.top().idx;
+        heap.pop();
+        ++stats.pops;
+        return idx;
+    }
+
+    OpenSetStats stats;
+
+private:
+    struct Entry {
+        int idx;
+        float key;
+        bool operator>(const Entry& other) const { return key > other.key; }
+    };
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+};
+
+// Indexed D-ary heap with true decrease-key.
+// pos[] maps a node to its slot in the heap so each node is queued at most once.
+template <int D>
+class IndexedDaryHeap {
+public:
+    void reset(size_t nodeCount) {
+        // Only nodes still queued have a valid slot, so clearing them is O(size)
+        for (const Entry& e : heap) pos[e.idx] = -1;
+        heap.clear();
+        if (pos.size() < nodeCount) pos.resize(nodeCount, -1);
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    float minKey() const { return heap[0].key; }
+
+    void push(int idx, float key) {
+        int slot = pos[idx];
+        if (slot >= 0) {
+            if (key < heap[slot].key) {
+                heap[slot].key = key;
+                siftUp(slot);
+                ++stats.decreases;
+            }
+            return;
+        }
+        heap.push_back({idx, key});
+        pos[idx] = static_cast<int>(heap.size() - 1);
+        siftUp(static_cast<int>(heap.size() - 1));
+        ++stats.pushes;
+        if (heap.size() > stats.peakSize) {
+            stats.peakSize = heap.size();
+            stats.peakBytes = heap.size() * sizeof(Entry) + pos.size() * sizeof(int);
+        }
+    }
+
+    int pop() {
+        int idx = heap[0].idx;
+        pos[idx] = -1;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            pos[last.idx] = 0;
+            siftDown(0);
+        }
+        ++stats.pops;
+        return idx;
+    }
+
+    OpenSetStats stats;
+
+private:
+    struct Entry {
+        int idx;
+        float key;
+    };
+    std::vector<Entry> heap;
+    std::vector<int> pos;
+
+    void siftUp(int i) {
+        Entry e = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / D;
+            if (heap[parent].key <= e.key) break;
+            heap[i] = heap[parent];
+            pos[heap[i].idx] = i;
+            i = parent;
+        }
+        heap[i] = e;
+        pos[e.idx] = i;
+    }
+
+    void siftDown(int i) {
+        Entry e = heap[i];
+        int n = static_cast<int>(heap.size());
+        while (true) {
+            int first = i * D + 1;
+            if (first >= n) break;
+            int best = first;
+            int end = std::min(first + D, n);
+            for (int c = first + 1; c < end; ++c) {
+                if (heap[c].key < heap[best].key) best = c;
+            }
+            if (heap[best].key >= e.key) break;
+            heap[i] = heap[best];
+            pos[heap[i].idx] = i;
+            i = best;
+        }
+        heap[i] = e;
+        pos[e.idx] = i;
+    }
+};
+
+using QuaternaryHeapOpenSet = IndexedDaryHeap<4>;
+
+// Monotone radix heap over integer-quantised keys.
+// Keys are rounded to 1/scale and must never drop below the last popped key;
+// keys that do (only possible with an inconsistent heuristic) are clamped.
+// Decrease-key is lazy, like BinaryHeapOpenSet.
+class RadixHeapOpenSet {
+public:
+    explicit RadixHeapOpenSet(float scale = 1024.0f) : scale(scale) {}
+
+    void reset(size_t) {
+        for (auto& b : buckets) b.clear();
+        count = 0;
+        last = 0;
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    float minKey() const {
+        // Bucket 0 always holds keys equal to last once refilled
+        for (const auto& b : buckets) {
+            if (b.empty()) continue;
+            uint32_t m = b[0].key;
+            for (const Entry& e : b) m = std::min(m, e.key);
+            return m / scale;
+        }
+        return 0.0f;
+    }
+
+    void push(int idx, float key) {
+        float scaled = key * scale;
+        uint32_t q = scaled >= 4294967295.0f ? 0xFFFFFFFFu : static_cast<uint32_t>(std::max(scaled, 0.0f));
+        if (q < last) q = last;
+        buckets[bucketFor(q)].push_back({idx, q});
+        ++count;
+        ++stats.pushes;
+        if (count > stats.peakSize) {
+            stats.peakSize = count;
+            size_t bytes = 0;
+            for (const auto& b : buckets) bytes += b.capacity() * sizeof(Entry);
+            stats.peakBytes = bytes;
+        }
+    }
+
+    int pop() {
+        if (buckets[0].empty()) {
+            // Find the first non-empty bucket and redistribute it around its minimum
+            int i = 1;
+            while (buckets[i].empty()) ++i;
+            uint32_t m = buckets[i][0].key;
+            for (const Entry& e : buckets[i]) m = std::min(m, e.key);
+            last = m;
+            for (const Entry& e : buckets[i]) buckets[bucketFor(e.key)].push_back(e);
+            buckets[i].clear();
+        }
+        int idx = buckets[0].back().idx;
+        buckets[0].pop_back();
+        --count;
+        ++stats.pops;
+        return idx;
+    }
+
+    OpenSetStats stats;
+
+private:
+    struct Entry {
+        int idx;
+        uint32_t key;
+    };
+    static constexpr int BucketCount = 33;
+
+    std::vector<Entry> buckets[BucketCount];
+    size_t count = 0;
+    uint32_t last = 0;
+    float scale;
+
+    // Bucket i holds keys whose highest bit differing from last is bit i-1
+    int bucketFor(uint32_t key) const {
+        uint32_t diff = key ^ last;
+        int b = 0;
+        while (diff) { diff >>= 1; ++b; }
+        return b;
+    }
+};
\ No newline at end of file
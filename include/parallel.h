@@ -0,0 +1,70 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Number of worker threads to use when the caller doesn't say
+inline int hardwareThreads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? static_cast<int>(n) : 1;
+}
+
+// Call fn(i, worker) for every i in [0, count) on up to `threads` threads.
+// Work is handed out dynamically in chunks of `grain`, so uneven items balance out.
+// worker is in [0, threads) and can index per-thread scratch space.
+template <class Fn>
+void parallelFor(int count, Fn fn, int threads = 0, int grain = 1) {
+    if (threads <= 0) threads = hardwareThreads();
+    threads = std::max(1, std::min(threads, (count + grain - 1) / std::max(grain, 1)));
+    if (threads <= 1) {
+        for (int i = 0; i < count; ++i) fn(i, 0);
+        return;
+    }
+
+    std::atomic<int> next(0);
+    auto worker = [&](int w) {
+        while (true) {
+            int begin = next.fetch_add(grain);
+            if (begin >= count) break;
+            int end = std::min(begin + grain, count);
+            for (int i = begin; i < end; ++i) fn(i, w);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (int w = 1; w < threads; ++w) pool.emplace_back(worker, w);
+    worker(0);
+    for (auto& t : pool) t.join();
+}
+
+// Sort [first, last) on up to `threads` threads: the range is split into chunks
+// sorted concurrently, then merged pairwise (also concurrently) until one run remains.
+// Not stable. Small ranges are sorted on the calling thread.
+template <class It, class Compare>
+void parallelSort(It first, It last, Compare comp, int threads = 0) {
+    const ptrdiff_t n = last - first;
+    const ptrdiff_t minChunk = 1 << 14;
+    if (threads <= 0) threads = hardwareThreads();
+    int chunks = static_cast<int>(std::min<ptrdiff_t>(threads, n / minChunk));
+    if (chunks <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<It> bounds(chunks + 1);
+    for (int c = 0; c <= chunks; ++c) bounds[c] = first + n * c / chunks;
+    parallelFor(chunks, [&](int c, int) { std::sort(bounds[c], bounds[c + 1], comp); }, threads);
+
+    // Merge neighbouring runs: width 1 -> 2 -> 4 ... runs
+    for (int width = 1; width < chunks; width *= 2) {
+        int pairs = (chunks + 2 * width - 1) / (2 * width);
+        parallelFor(pairs, [&](int p, int) {
+            int lo = 2 * width * p;
+            int mid = std::min(lo + width, chunks), hi = std::min(lo + 2 * width, chunks);
+            if (mid < hi) std::inplace_merge(bounds[lo], bounds[mid], bounds[hi], comp);
+        }, threads);
+    }
+}
@@ -1,10 +1,11 @@
 #pragma once
 #include <vector>
-#include <queue>
-#include <functional>
 #include <glm/glm.hpp>
 #include <cmath>
-#include <unordered_set>
+#include <cstdint>
+#include <limits>
+#include "open_set.h"
+#include "cost_models.h"
 
 // Edge in the graph
 struct Edge {
@@ -18,14 +19,171 @@ struct Node {
     std::vector<Edge> neighbors;
 };
 
-// Build adjacency list from terrain vertices/indices
+// Slope-based cost of walking from a to b (never below 1)
+float edgeCost(const glm::vec3& a, const glm::vec3& b);
+
+// Build adjacency list from terrain vertices/indices (SlopeCost edges)
 std::vector<Node> buildGraph(const std::vector<glm::vec3>& vertices,
                              const std::vector<unsigned int>& indices);
 
+// Same, with edge costs from a cost policy (see cost_models.h).
+// Both directions are costed separately, so asymmetric models work too.
+template <class Cost>
+std::vector<Node> buildGraph(const std::vector<glm::vec3>& vertices,
+                             const std::vector<unsigned int>& indices, const Cost& cost) {
+    std::vector<Node> graph(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        graph[i].position = vertices[i];
+    }
+
+    // Each triangle gives 3 edges
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        int corner[3] = {(int)indices[i], (int)indices[i+1], (int)indices[i+2]};
+        for (int k = 0; k < 3; ++k) {
+            int a = corner[k], b = corner[(k + 1) % 3];
+            graph[a].neighbors.push_back({b, cost(vertices[a], vertices[b])});
+            graph[b].neighbors.push_back({a, Cost::symmetric ? graph[a].neighbors.back().cost
+                                                             : cost(vertices[b], vertices[a])});
+        }
+    }
+    return graph;
+}
+
+// Longest horizontal edge length (SlopeCost::maxStep)
+float maxHorizontalStep(const std::vector<Node>& graph);
+
+// Arc from -> to whose cost in the graph changed
+struct EdgeChange {
+    int from;
+    int to;
+};
+
+// Move node v to height y and recompute the cost of every edge touching it.
+// Returns the arcs whose cost changed (both directions).
+std::vector<EdgeChange> setNodeHeight(std::vector<Node>& graph, int v, float y);
+
 // Convert path indices into renderable vertex data [x y z r g b]
 std::vector<float> buildPathVertexData(const std::vector<Node>& graph,
                                        const std::vector<int>& path);
 
+// Sum of edge costs along a path (infinity if two consecutive nodes aren't adjacent)
+float pathCost(const std::vector<Node>& graph, const std::vector<int>& path);
+
+// Smallest edge cost per unit of straight-line length over the whole graph.
+// heuristicScale * |a - b| never overestimates and is consistent.
+float heuristicScale(const std::vector<Node>& graph);
+
+// Full Dijkstra from source: cost to every node (infinity if unreachable)
+std::vector<float> shortestDistances(const std::vector<Node>& graph, int source);
+
+// Reusable per-query search state (dist/prev/closed).
+// Entries are only valid when their stamp matches the current generation,
+// so starting a new query is O(1) instead of refilling O(V) arrays.
+class SearchWorkspace {
+public:
+    SearchWorkspace() = default;
+    explicit SearchWorkspace(size_t nodeCount) { beginQuery(nodeCount); }
+
+    // Grow to fit the graph if needed and invalidate the previous query
+    void beginQuery(size_t nodeCount);
+
+    float dist(int v) const {
+        return stamp[v] == generation ? distance[v] : std::numeric_limits<float>::infinity();
+    }
+    int prev(int v) const { return stamp[v] == generation ? parent[v] : -1; }
+    void set(int v, float d, int p) {
+        stamp[v] = generation;
+        distance[v] = d;
+        parent[v] = p;
+    }
+
+    bool isClosed(int v) const { return closedStamp[v] == generation; }
+    void close(int v) { closedStamp[v] = generation; }
+
+    // Follow prev pointers back from target
+    std::vector<int> pathTo(int target) const;
+
+    size_t size() const { return stamp.size(); }
+
+    QuaternaryHeapOpenSet openSet; // reused by findPath and Pathfinder
+
+private:
+    std::vector<float> distance;
+    std::vector<int> parent;
+    std::vector<uint32_t> stamp;
+    std::vector<uint32_t> closedStamp;
+    uint32_t generation = 0;
+};
+
+// One-shot A* from startIndex to goalIndex
+std::vector<int> findPath(const std::vector<Node>& graph, int startIndex, int goalIndex);
+std::vector<int> findPath(const std::vector<Node>& graph, int startIndex, int goalIndex,
+                          SearchWorkspace& ws);
+
+// A* core with explicit open-set, edge-weight and heuristic policies.
+// weightOf(u, edge) returns the cost of the edge leaving u; estimate(v) returns
+// the (already weighted) cost-to-goal guess for node v. Both are template
+// parameters so they inline into the loop.
+template <class OpenSet, class EdgeWeight, class Heuristic>
+std::vector<int> findPathWithCosts(const std::vector<Node>& graph, int startIndex, int goalIndex,
+                                   SearchWorkspace& ws, OpenSet& openSet,
+                                   EdgeWeight weightOf, Heuristic estimate) {
+    ws.beginQuery(graph.size());
+    openSet.reset(graph.size());
+
+    ws.set(startIndex, 0.0f, -1);
+    openSet.push(startIndex, estimate(startIndex));
+
+    while (!openSet.empty()) {
+        int u = openSet.pop();
+        if (ws.isClosed(u)) continue; // stale duplicate
+        ws.close(u);
+        if (u == goalIndex) break;
+
+        float du = ws.dist(u);
+        for (const Edge& e : graph[u].neighbors) {
+            float tentative_g = du + weightOf(u, e);
+            if (tentative_g < ws.dist(e.to)) {
+                ws.set(e.to, tentative_g, u);
+                if (ws.isClosed(e.to)) continue; // would only be popped and skipped
+                openSet.push(e.to, tentative_g + estimate(e.to));
+            }
+        }
+    }
+
+    return ws.pathTo(goalIndex);
+}
+
+// A* over the costs stored in the graph with an explicit open-set policy
+// (see open_set.h) and heuristic
+template <class OpenSet, class Heuristic>
+std::vector<int> findPathWithHeuristic(const std::vector<Node>& graph, int startIndex, int goalIndex,
+                                       SearchWorkspace& ws, OpenSet& openSet, Heuristic estimate) {
+    return findPathWithCosts(graph, startIndex, goalIndex, ws, openSet,
+                             [](int, const Edge& e) { return e.cost; }, estimate);
+}
+
+// Same search with the weighted Euclidean heuristic
+template <class OpenSet>
+std::vector<int> findPathWith(const std::vector<Node>& graph, int startIndex, int goalIndex,
+                              SearchWorkspace& ws, OpenSet& openSet, float weight = 15.0f) {
+    const glm::vec3 goalPos = graph[goalIndex].position;
+    return findPathWithHeuristic(graph, startIndex, goalIndex, ws, openSet, [&](int v) {
+        return glm::length(graph[v].position - goalPos) * weight;
+    });
+}
+
+// A* that costs edges with a policy instead of the stored costs, so one graph
+// can serve several cost models. weight 1 is optimal; larger trades quality for speed.
+template <class Cost>
+std::vector<int> findPathModel(const std::vector<Node>& graph, int startIndex, int goalIndex,
+                               SearchWorkspace& ws, const Cost& cost, float weight = 1.0f) {
+    const glm::vec3 goalPos = graph[goalIndex].position;
+    return findPathWithCosts(graph, startIndex, goalIndex, ws, ws.openSet,
+        [&](int u, const Edge& e) { return cost(graph[u].position, graph[e.to].position); },
+        [&](int v) { return weight * cost.lowerBound(graph[v].position, goalPos); });
+}
+
 // Live search visualization
 struct SearchState {
     std::vector<int> visited;   // nodes expanded so far
@@ -33,27 +191,95 @@ struct SearchState {
     std::vector<int> path;      // final path once goal reached
 };
 
-class Pathfinder {
+// Common interface for searches that advance one expansion at a time
+class SteppableSearch {
+public:
+    virtual ~SteppableSearch() = default;
+    virtual bool step(SearchState& state) = 0; // advance one iteration, fill state
+    virtual std::vector<int> currentBestPath(int target) const = 0;
+    virtual int parentOf(int v) const = 0;     // v's predecessor on its best path, -1 at a root
+};
+
+class LandmarkTable;
+
+class Pathfinder : public SteppableSearch {
 public:
     Pathfinder(const std::vector<Node>& g, int s, int goal);
-    bool step(SearchState& state); // advance one iteration, fill state
+    Pathfinder(const std::vector<Node>& g, int s, int goal, SearchWorkspace& workspace);
+    // Optimal search guided by landmark lower bounds instead of weighted Euclidean
+    Pathfinder(const std::vector<Node>& g, int s, int goal, const LandmarkTable& landmarks);
+    Pathfinder(const Pathfinder&) = delete;
+    Pathfinder& operator=(const Pathfinder&) = delete;
 
-    std::vector<int> currentBestPath(int target) const;
+    bool step(SearchState& state) override;
+
+    std::vector<int> currentBestPath(int target) const override;
+    int parentOf(int v) const override { return ws->prev(v); }
 
 private:
     const std::vector<Node>& graph;
     int startIndex, goalIndex;
-    std::vector<float> dist;
-    std::vector<int> prev;
+    SearchWorkspace ownWorkspace;   // used when no shared workspace is given
+    SearchWorkspace* ws;
+    const LandmarkTable* landmarks = nullptr;
 
-    struct NodeEntry {
-        int idx;
-        float f;
-        bool operator>(const NodeEntry& other) const { return f > other.f; }
-    };
+    void start();
+    float estimate(int v) const; // heuristic term added to g
+    static float heuristic(const glm::vec3& a, const glm::vec3& b);
+};
 
-    std::priority_queue<NodeEntry, std::vector<NodeEntry>, std::greater<NodeEntry>> openSet;
-    std::unordered_set<int> visitedSet;
+// Steppable A* whose edge costs and heuristic come from a cost policy
+// (see cost_models.h); everything is inlined per policy. weight 1 is optimal.
+template <class Cost>
+class ModelPathfinder : public SteppableSearch {
+public:
+    ModelPathfinder(const std::vector<Node>& g, int s, int goal, const Cost& cost = Cost(), float weight = 1.0f)
+        : graph(g), startIndex(s), goalIndex(goal), cost(cost), weight(weight)
+    {
+        ws.beginQuery(graph.size());
+        ws.openSet.reset(graph.size());
+        ws.set(startIndex, 0.0f, -1);
+        ws.openSet.push(startIndex, estimate(startIndex));
+    }
+    ModelPathfinder(const ModelPathfinder&) = delete;
+    ModelPathfinder& operator=(const ModelPathfinder&) = delete;
 
-    static float heuristic(const glm::vec3& a, const glm::vec3& b);
-};
\ No newline at end of file
+    bool step(SearchState& state) override {
+        state.frontier.clear();
+        if (ws.openSet.empty()) return false;
+
+        int u = ws.openSet.pop();
+        if (ws.isClosed(u)) return true;
+        ws.close(u);
+        state.visited.push_back(u);
+
+        if (u == goalIndex) {
+            state.path = ws.pathTo(goalIndex);
+            return false;
+        }
+
+        float du = ws.dist(u);
+        for (const Edge& e : graph[u].neighbors) {
+            float tentative_g = du + cost(graph[u].position, graph[e.to].position);
+            if (tentative_g < ws.dist(e.to)) {
+                ws.set(e.to, tentative_g, u);
+                if (ws.isClosed(e.to)) continue;
+                ws.openSet.push(e.to, tentative_g + estimate(e.to));
+                state.frontier.push_back(e.to);
+            }
+        }
+        return true;
+    }
+
+    std::vector<int> currentBestPath(int target) const override { return ws.pathTo(target); }
+    int parentOf(int v) const override { return ws.prev(v); }
+
+private:
+    const std::vector<Node>& graph;
+    int startIndex, goalIndex;
+    Cost cost;
+    float weight;
+    SearchWorkspace ws;
+
+    float estimate(int v) const { return weight * cost.lowerBound(graph[v].position, graph[goalIndex].position); }
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+
+// A local maximum of the terrain and how much it stands out
+struct Peak {
+    int vertex;
+    float height;
+    float prominence;   // height above the key saddle (above the lowest point for the highest peak)
+    int keySaddle;      // vertex where it first joins higher ground; -1 for the highest peak
+};
+
+// Every local maximum of the mesh with its topographic prominence, largest
+// prominence first (so the highest point comes first); topK > 0 keeps only
+// that many. Equal heights are ordered by vertex index, so flat tops count once.
+//
+// Vertices are swept from high to low (parallel sort) and joined into islands
+// with union-find. A vertex with no processed neighbour starts an island at a
+// new peak; one that touches several islands is a saddle: the island with the
+// highest peak absorbs the others, and each of their peaks has found its key
+// saddle. O(N log N) for the sort plus a near-linear sweep.
+std::vector<Peak> findPeaks(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+                            size_t topK = 0, int threads = 0);
+
+// Point vertex data [x y z r g b] marking the peaks, brightest for the most prominent
+std::vector<float> buildPeakMarkerData(const std::vector<glm::vec3>& positions, const std::vector<Peak>& peaks);
@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include "pathfinding.h"
+
+class LandmarkTable;
+
+struct RouteQuery {
+    int start;
+    int goal;
+};
+
+struct RouteResult {
+    std::vector<int> path;   // empty if the goal is unreachable
+    float cost = 0.0f;       // infinity if unreachable
+    double latencyMs = 0.0;  // time spent on this query by its worker
+};
+
+// Throughput and latency report for one batch
+struct BatchStats {
+    size_t queries = 0;
+    int threads = 0;
+    double wallMs = 0.0;
+    double queriesPerSecond = 0.0;
+    double p50Ms = 0.0, p90Ms = 0.0, p99Ms = 0.0, maxMs = 0.0;
+};
+
+// Answers batches of start->goal queries on a worker pool.
+// The graph (and landmark table, if any) is shared read-only; every worker has
+// its own SearchWorkspace, kept between batches so steady-state queries don't
+// allocate. Queries are exact A*: landmark bounds when a table is given,
+// otherwise the consistent Euclidean heuristic from heuristicScale.
+class RouteQueryEngine {
+public:
+    explicit RouteQueryEngine(const std::vector<Node>& g, int threads = 0);
+    RouteQueryEngine(const std::vector<Node>& g, const LandmarkTable& landmarks, int threads = 0);
+
+    // Results are in query order. stats (optional) receives throughput and percentiles.
+    std::vector<RouteResult> run(const std::vector<RouteQuery>& queries, BatchStats* stats = nullptr);
+
+    int threadCount() const { return threads; }
+
+private:
+    const std::vector<Node>& graph;
+    const LandmarkTable* landmarks = nullptr;
+    int threads;
+    float hScale;
+    std::vector<SearchWorkspace> workspaces;  // one per worker
+
+    void answer(const RouteQuery& q, SearchWorkspace& ws, RouteResult& out) const;
+};
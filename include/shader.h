@@ -1,5 +1,68 @@
 #pragma once
 #include <string>
+#include <unordered_map>
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 
-unsigned int compileShader(const char* vertexSrc, const char* fragmentSrc);
\ No newline at end of file
+// Compile and link a program; prints the info log and returns 0 if any stage fails.
+// retrievable asks the driver to keep the binary for glGetProgramBinary.
+unsigned int compileShader(const char* vertexSrc, const char* fragmentSrc, bool retrievable = false);
+
+// Per-frame values shared by every program, as the std140 block in shaders/frame.glsl
+// declares. Written once per frame into a uniform buffer bound at FRAME_BINDING.
+struct FrameUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 viewPos;           // xyz
+    glm::vec4 lightDir;          // xyz: direction the light travels, w: sun elevation (radians)
+    glm::vec4 sunWeights[4];     // HorizonMap::sunWeights for the sun
+};
+static_assert(sizeof(FrameUniforms) == 2 * 64 + 6 * 16, "FrameUniforms must match the std140 layout");
+
+const GLuint FRAME_BINDING = 0;
+
+// A linked program with the locations of its active uniforms read once, at
+// link time, so drawing never looks uniforms up by string. Its Frame block,
+// if it has one, is bound to FRAME_BINDING.
+class ShaderProgram {
+public:
+    ShaderProgram(const char* vertexSrc, const char* fragmentSrc);
+    explicit ShaderProgram(unsigned int linkedProgram);   // takes ownership
+    ~ShaderProgram() { release(); }
+    ShaderProgram(const ShaderProgram&) = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+
+    bool valid() const { return program != 0; }
+    unsigned int id() const { return program; }
+    void use() const { glUseProgram(program); }
+
+    // Location of an active uniform (arrays by their bare name too), -1 if the program
+    // doesn't use it. Resolve once at setup and keep the result for per-frame uploads.
+    GLint uniform(const std::string& name) const;
+
+    // Replace the program (e.g. after a reload) with another linked one, which
+    // this then owns; uniform locations must be resolved again
+    void reset(unsigned int linkedProgram);
+    void release();   // delete the program (before the context goes away)
+
+private:
+    unsigned int program = 0;
+    std::unordered_map<std::string, GLint> locations;
+
+    void reflect();
+};
+
+// The uniform buffer behind the Frame block
+class FrameUniformBuffer {
+public:
+    FrameUniformBuffer();
+    ~FrameUniformBuffer() { release(); }
+    FrameUniformBuffer(const FrameUniformBuffer&) = delete;
+    FrameUniformBuffer& operator=(const FrameUniformBuffer&) = delete;
+
+    void update(const FrameUniforms& frame);   // one upload per frame
+    void release();
+
+private:
+    GLuint buffer = 0;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "shader.h"
+
+struct GLFWwindow;
+
+// Shader programs built from GLSL files, with a program binary cache and hot reload.
+// A linked program is saved with glGetProgramBinary under a key hashed from its
+// preprocessed sources and the driver (vendor, renderer, version), so a later start
+// with the same key skips compiling; a driver or source change just misses. Binaries
+// need GL 4.1; on an older context every load compiles.
+// watch() polls the files on a thread with a context of its own, recompiles what
+// changed there and applyReloads() swaps the results in between frames; a reload
+// that fails to compile keeps the old program running.
+// Sources can #include "file" (relative to the shader directory) after #version.
+// Create with the render context current.
+class ShaderLibrary {
+public:
+    ShaderLibrary(std::string shaderDir, std::string cacheDir);
+    ~ShaderLibrary() { stop(); }
+    ShaderLibrary(const ShaderLibrary&) = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+    // Build (or restore) a program; check valid() on the result. The reference
+    // stays the same across reloads for the library's lifetime.
+    ShaderProgram& load(const std::string& name, const std::string& vertexFile, const std::string& fragmentFile);
+
+    // Start the watcher. workerContext shares objects with the render context
+    // (a hidden 1x1 window) and is only made current on the watcher thread.
+    void watch(GLFWwindow* workerContext, int intervalMs = 300);
+    void stop();
+
+    // On the render thread: swap in programs rebuilt since the last call, returns how
+    // many. Their uniforms have to be set and resolved again.
+    int applyReloads();
+
+    void release();   // stop watching and delete every program (before the context goes away)
+
+    int cacheHits() const { return hits; }
+    int cacheMisses() const { return misses; }
+    double loadMs() const { return loadTime; }
+
+private:
+    struct Entry {
+        std::string name, vertexFile, fragmentFile;
+        std::unique_ptr<ShaderProgram> program;
+        std::vector<std::string> files;            // everything read to build it, includes too
+        std::filesystem::file_time_type stamp;     // newest write time among them when built
+    };
+    struct Sources {
+        std::string vertex, fragment;
+        std::vector<std::string> files;
+        std::filesystem::file_time_type newest = std::filesystem::file_time_type::min();   // of files, before reading
+    };
+    struct Reload {
+        size_t entry;
+        unsigned int program;
+    };
+
+    std::string shaderDir, cacheDir;
+    std::string driver;               // vendor, renderer and version, part of every cache key
+    bool binariesSupported = false;
+    int hits = 0, misses = 0;
+    double loadTime = 0.0;
+
+    std::vector<std::unique_ptr<Entry>> entries;
+    std::vector<Reload> ready;        // built by the watcher, not yet swapped in
+    std::mutex lock;                  // entries' files and stamps, ready
+    std::condition_variable wake;
+    std::atomic<bool> running{false};
+    std::thread watcher;
+
+    bool readSources(const Entry& entry, Sources& out) const;
+    bool preprocess(const std::string& file, std::string& out, std::vector<std::string>& files,
+                    std::filesystem::file_time_type& newest, int depth) const;
+    std::filesystem::file_time_type newestWrite(const std::vector<std::string>& files) const;
+    std::string cachePath(const std::string& name, const Sources& sources) const;
+    unsigned int loadBinary(const std::string& path) const;
+    void saveBinary(unsigned int program, const std::string& name, const std::string& path) const;
+    unsigned int build(const Entry& entry, Sources& sources, bool& fromCache) const;
+    void poll();
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include "async_search.h"
+#include "camera.h"
+#include "contours.h"
+#include "input.h"
+#include "pathfinding.h"
+#include "triple_buffer.h"
+#include "viewshed.h"
+
+// Everything the render thread needs for one frame. The camera, sun and toggles
+// are absolute; the overlays are changes against the packet before, which the
+// simulation folds together when the renderer skips packets (see TripleBuffer::reclaim).
+struct FramePacket {
+    uint64_t tick = 0;
+
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::vec3 viewPos = glm::vec3(0.0f);
+    glm::vec3 toSun = glm::vec3(0.0f, 1.0f, 0.0f);   // unit
+
+    bool wireframe = false;
+    bool showHeatmap = false;
+    bool showAlternatives = false;
+    bool showRivers = false;
+    bool showContours = false;
+    bool showViewshed = false;
+
+    // Search playback: the first visitedShown expansions are drawn, the last
+    // visitedAdded of them new since the previous packet
+    size_t visitedShown = 0;
+    std::vector<int> visitedAdded;
+    bool frontierChanged = false;   // frontier replaces the one drawn
+    std::vector<int> frontier;
+    bool showFrontier = false;      // playback has caught up with the search
+    // Best path as GL_LINES data: keep the first pathKept segments drawn, then pathTail
+    bool pathChanged = false;
+    size_t pathKept = 0;
+    std::vector<float> pathTail;
+    // Viewshed mask bytes from viewshedFirst on changed to viewshedBytes
+    bool viewshedChanged = false;
+    size_t viewshedFirst = 0;
+    std::vector<uint8_t> viewshedBytes;
+    // Contour vertex data, replaced whole
+    bool contoursChanged = false;
+    std::vector<float> contourData;
+    size_t contourSegments = 0;
+
+    void clearChanges();   // keeps the vectors' storage
+    // Record a path change, on top of an earlier one this packet already holds
+    void setPath(size_t kept, const std::vector<float>& tail);
+};
+
+// Input, camera, search playback and overlay updates on a thread of their own,
+// at a fixed tick rate, so a slow viewshed, contour rebuild or burst of search
+// results delays the next packet rather than the next frame. The render thread
+// draws the newest packet each frame and only ever uploads what it carries.
+// Everything passed in belongs to this thread while it runs.
+class Simulation {
+public:
+    Simulation(const std::vector<Node>& graph, AsyncSearch& search, Viewshed& viewshed, ContourMap& contours,
+               int peakIndex, float aspect, double tickHz = 240.0);
+    ~Simulation() { stop(); }
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    // Runs one tick at once, so the first frame has a packet, then starts the thread
+    void start();
+    void stop();
+    // Instead of start(): one tick on the calling thread with the camera placed by
+    // the caller, for reproducible replays
+    void step(float deltaTime, const Camera& placed);
+
+    // GLFW callbacks feed this on the main thread (InputQueue::install)
+    InputQueue& input() { return inputs; }
+
+    // Render thread: move to the newest packet; false if there is none since the last call
+    bool takeFrame() { return packets.take(); }
+    const FramePacket& frame() const { return packets.front(); }
+
+private:
+    const std::vector<Node>& graph;
+    AsyncSearch& search;
+    Viewshed& viewshed;
+    ContourMap& contours;
+    int peakIndex;
+    float aspect;
+    double tickHz;
+
+    InputQueue inputs;
+    TripleBuffer<FramePacket> packets;
+    std::atomic<bool> running{false};
+    std::thread worker;
+    uint64_t ticks = 0;
+
+    Camera camera;
+    FramePacket state;   // toggles carried from tick to tick
+    float sunAzimuth, sunElevation;
+    bool lowSun = false;
+
+    SearchUpdate searchUpdate;      // accumulates every expansion received so far
+    double playhead = 0.0;          // expansions shown
+    double playbackRate = 100.0;    // expansions per second, [ and ] halve/double it
+    size_t visitedSent = 0;
+    std::vector<int> shownParent;   // per node, its parent as of the last shown expansion
+    std::vector<int> drawnPath;
+
+    int viewshedObserver = -1;
+    std::vector<uint8_t> sentMask;  // the viewshed mask as published
+
+    void tick(float deltaTime);
+};
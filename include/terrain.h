@@ -1,9 +1,13 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 // terrain generator
 float generateTerrain(int N, std::vector<float>& vertices, std::vector<unsigned int>& indices);
 
+// terrain generator with a fixed Perlin seed (reproducible maps for benchmarks)
+float generateTerrain(int N, std::vector<float>& vertices, std::vector<unsigned int>& indices, uint32_t seed);
+
 // compute normals for the terrain mesh
 void computeNormals(const std::vector<float>& vertices, const std::vector<unsigned int>& indices, std::vector<float>& normals);
\ No newline at end of file
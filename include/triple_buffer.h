@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+
+// Latest-value hand-off between one writer thread and one reader thread, with
+// neither ever waiting: the writer fills back() and publishes it, the reader
+// takes the newest published slot as front(). Three slots, so both always have
+// one of their own and the third is the one in flight.
+//
+// A reader that falls behind skips packets. When they carry deltas, the writer
+// calls reclaim() before writing: if the last published slot hasn't been taken
+// yet it comes back as back(), still filled, to be extended instead of started over.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side
+    T& back() { return slots[backSlot]; }
+    // Take back the last published slot if the reader hasn't; true if back() now holds it
+    bool reclaim() {
+        int shared = ready.load(std::memory_order_relaxed);
+        if (!(shared & FRESH)) return false;
+        // Leave our (stale) slot in its place, not marked fresh; fails if the reader got there first
+        if (!ready.compare_exchange_strong(shared, backSlot, std::memory_order_acquire)) return false;
+        backSlot = shared & SLOT;
+        return true;
+    }
+    void publish() {
+        backSlot = ready.exchange(backSlot | FRESH, std::memory_order_acq_rel) & SLOT;
+    }
+
+    // Reader side: move to the newest published slot; false (front() unchanged) if none
+    bool take() {
+        int shared = ready.load(std::memory_order_relaxed);
+        // A compare-exchange, as the writer may reclaim the slot between the load and the swap
+        while (shared & FRESH) {
+            if (ready.compare_exchange_weak(shared, frontSlot, std::memory_order_acq_rel)) {
+                frontSlot = shared & SLOT;
+                return true;
+            }
+        }
+        return false;
+    }
+    const T& front() const { return slots[frontSlot]; }
+
+private:
+    static const int SLOT = 3, FRESH = 4;
+    T slots[3];
+    std::atomic<int> ready{1};   // slot index | FRESH once published and not yet taken
+    int backSlot = 0;            // writer's
+    int frontSlot = 2;           // reader's
+};
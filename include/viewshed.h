@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "height_grid.h"
+
+// What can be seen from a grid vertex, by an XDraw-style sweep.
+// Terrain vertices form a side x side grid (index i * side + j, x along i,
+// z along j). Rings of cells around the observer are processed outwards in
+// each of the 8 octants; every cell keeps the steepest sight-line slope that
+// reaches it, linearly interpolated from the two cells of the previous ring
+// its ray passes between. A cell is visible when its own slope from the eye
+// is at least that. O(cells) per observer with no per-ray marching; the
+// octants are independent and run in parallel. The result is approximate
+// (interpolation), typically within a few percent of exact ray casting.
+class Viewshed {
+public:
+    // positions must be the full terrain grid; side is taken from its size
+    explicit Viewshed(const std::vector<glm::vec3>& positions, int threads = 0);
+
+    // Visibility from vertex observer with the eye eyeHeight above the ground.
+    // targetHeight raises every target (e.g. a person standing there).
+    // Returns one byte per vertex, 255 visible / 0 hidden, ready to upload as a
+    // normalised vertex attribute.
+    const std::vector<uint8_t>& compute(int observer, float eyeHeight = 0.01f, float targetHeight = 0.0f);
+
+    const std::vector<uint8_t>& mask() const { return visible; }
+    size_t visibleCount() const { return seen; }
+    double lastMs() const { return computeTime; }
+    const HeightGrid& grid() const { return terrain; }
+    int nearestVertex(float x, float z) const { return terrain.nearestVertex(x, z); }
+
+private:
+    HeightGrid terrain;   // heights copied for cache-friendly access
+    std::vector<uint8_t> visible;
+    int threads;
+    size_t seen = 0;
+    double computeTime = 0.0;
+
+    size_t sweepOctant(int octant, int oi, int oj, float eye, float targetHeight);
+};
@@ -0,0 +1,8 @@
+// Per-frame values shared by every program; FrameUniforms in shader.h mirrors this layout
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;           // xyz
+    vec4 lightDir;          // xyz: direction the light travels, w: sun elevation (radians)
+    vec4 sunWeights[4];     // blend of the two horizon azimuths around the sun
+};
@@ -0,0 +1,13 @@
+#version 330 core
+#include "frame.glsl"
+
+// Search nodes drawn straight from the terrain VBO through an index buffer of node ids
+layout (location = 0) in vec3 aPos;
+out vec3 vColor;
+uniform mat4 model;
+uniform vec3 color;
+uniform float lift;
+void main() {
+    vColor = color;
+    gl_Position = projection * view * model * vec4(aPos + vec3(0.0, lift, 0.0), 1.0);
+}
@@ -0,0 +1,14 @@
+#version 330 core
+#include "frame.glsl"
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+
+out vec3 vColor;
+
+uniform mat4 model;
+
+void main() {
+    vColor = aColor;
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
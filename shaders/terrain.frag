@@ -0,0 +1,59 @@
+#version 330 core
+#include "frame.glsl"
+
+in vec3 FragPos;
+in vec3 Normal;
+in float Visible;
+in float Channel;
+in float SunHorizon;
+in float Sky;
+
+out vec4 FragColor;
+
+uniform float maxHeight;
+uniform bool showViewshed;
+uniform bool showRivers;
+
+void main() {
+    vec3 norm = normalize(Normal);
+    float diff = max(dot(norm, lightDir.xyz), 0.0);
+
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
+    vec3 reflectDir = reflect(lightDir.xyz, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 8);
+    vec3 specular = vec3(0.03) * spec;
+
+    float h = clamp(FragPos.y / maxHeight, 0.0, 1.0);
+    vec3 lowColor  = vec3(0.25, 0.25, 0.45);
+    vec3 midColor  = vec3(0.35, 0.75, 0.35);
+    vec3 highColor = vec3(0.85, 0.85, 0.85);
+
+    vec3 baseColor = mix(lowColor, midColor, smoothstep(0.001, 0.05, h));
+    baseColor = mix(baseColor, highColor, smoothstep(0.6, 1.0, h));
+
+    vec3 rockColor = vec3(0.5, 0.5, 0.5);
+    float slope = clamp(norm.y, 0.0, 1.0);
+    float rockFactor = 1.0 - slope;
+    baseColor = mix(baseColor, rockColor, 0.3 * rockFactor);
+
+    // Baked lighting: direct light fades out as the sun drops behind the horizon,
+    // ambient light by how much of the sky is open
+    float sunlit = smoothstep(SunHorizon - 0.03, SunHorizon + 0.03, lightDir.w);
+    specular *= sunlit;
+
+    float ambientStrength = 0.25;
+    vec3 ambient = ambientStrength * Sky * baseColor;
+    vec3 diffuse = 0.8 * diff * sunlit * baseColor;
+
+    vec3 result = ambient + diffuse + specular;
+    if (showRivers) {
+        result = mix(result, vec3(0.15, 0.35, 0.85) * (0.4 + 0.6 * diff), 0.85 * Channel);
+    }
+    if (showViewshed) {
+        // Hidden ground dimmed and cooled, visible ground slightly warmed
+        vec3 hidden = result * vec3(0.35, 0.4, 0.6);
+        vec3 seen = result * vec3(1.1, 1.05, 0.85);
+        result = mix(hidden, seen, Visible);
+    }
+    FragColor = vec4(result, 1.0);
+}
@@ -0,0 +1,34 @@
+#version 330 core
+#include "frame.glsl"
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in float aVisible;
+layout (location = 3) in float aChannel;
+layout (location = 4) in vec4 aHorizon0;   // baked horizon angles, 16 azimuths in [0, 1] = [0, pi/2]
+layout (location = 5) in vec4 aHorizon1;
+layout (location = 6) in vec4 aHorizon2;
+layout (location = 7) in vec4 aHorizon3;
+layout (location = 8) in float aSky;
+
+out vec3 FragPos;
+out vec3 Normal;
+out float Visible;
+out float Channel;
+out float SunHorizon;
+out float Sky;
+
+uniform mat4 model;
+uniform mat3 normalMatrix;
+
+void main() {
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    Normal = normalMatrix * aNormal;
+    Visible = aVisible;
+    Channel = aChannel;
+    // Horizon towards the sun, from the two azimuths around it
+    SunHorizon = 1.5707963 * (dot(aHorizon0, sunWeights[0]) + dot(aHorizon1, sunWeights[1]) +
+                              dot(aHorizon2, sunWeights[2]) + dot(aHorizon3, sunWeights[3]));
+    Sky = aSky;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,209 @@
+#include "alternatives.h"
+#include <algorithm>
+#include <limits>
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+RouteStats routeStats(const std::vector<Node>& graph, const std::vector<int>& path) {
+    RouteStats s;
+    s.cost = pathCost(graph, path);
+    float run = 0.0f;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        const glm::vec3& a = graph[path[i]].position;
+        const glm::vec3& b = graph[path[i+1]].position;
+        float rise = b.y - a.y;
+        s.length += glm::length(b - a);
+        s.climb += std::max(rise, 0.0f);
+        s.descent += std::max(-rise, 0.0f);
+        s.maxSlope = std::max(s.maxSlope, slopeBetween(a, b));
+        run += horizontalDistance(a, b);
+    }
+    s.meanSlope = run > 0.0f ? (s.climb + s.descent) / run : 0.0f;
+    return s;
+}
+
+AlternativeRouter::AlternativeRouter(const std::vector<Node>& g)
+    : graph(g), hScale(heuristicScale(g))
+{
+    onRoute.assign(graph.size(), 0u);
+    onCandidate.assign(graph.size(), 0u);
+}
+
+float AlternativeRouter::arcCost(int from, int to) const {
+    float best = INF;
+    for (const Edge& e : graph[from].neighbors) {
+        if (e.to == to) best = std::min(best, e.cost);
+    }
+    return best;
+}
+
+uint32_t AlternativeRouter::nextStamp() {
+    // Stamp 0 means "never marked"; on wrap-around clear the marks once
+    if (++stamp == 0) {
+        std::fill(onRoute.begin(), onRoute.end(), 0u);
+        std::fill(onCandidate.begin(), onCandidate.end(), 0u);
+        stamp = 1;
+    }
+    return stamp;
+}
+
+// A* from root with a consistent potential until the popped key passes
+// stretch * targetDist; targetDist is set when target is settled if it isn't
+// known yet. Every node with dist + potential within the limit ends up closed
+// with its exact distance. potential(v) = infinity leaves v out.
+// reverse grows the tree over incoming arcs (distances *to* root).
+template <class Potential>
+void AlternativeRouter::grow(SearchWorkspace& ws, int root, int target, bool reverse,
+                             float& targetDist, float stretch, Potential potential) {
+    ws.beginQuery(graph.size());
+    ws.openSet.reset(graph.size());
+    ws.set(root, 0.0f, -1);
+    ws.openSet.push(root, potential(root));
+
+    while (!ws.openSet.empty()) {
+        float key = ws.openSet.minKey();
+        int u = ws.openSet.pop();
+        if (ws.isClosed(u)) continue; // stale duplicate
+        if (key > stretch * targetDist) break;
+        ws.close(u);
+        ++settled;
+        if (!reverse) forwardOrder.push_back(u);
+        float du = ws.dist(u);
+        if (u == target && targetDist == INF) targetDist = du;
+
+        for (const Edge& e : graph[u].neighbors) {
+            float h = potential(e.to);
+            if (h == INF) continue;
+            // buildGraph adds every arc in both directions, so u's neighbours are its predecessors too
+            float tentative_g = du + (reverse ? arcCost(e.to, u) : e.cost);
+            if (tentative_g < ws.dist(e.to)) {
+                ws.set(e.to, tentative_g, u);
+                if (ws.isClosed(e.to)) continue;
+                ws.openSet.push(e.to, tentative_g + h);
+            }
+        }
+    }
+}
+
+// Mark every node within width (horizontally) of the path, by a flood from the path
+void AlternativeRouter::markCorridor(const std::vector<int>& path, float width, uint32_t routeStamp) {
+    uint32_t seen = nextStamp();
+    std::vector<std::pair<int, int>> queue;   // node, path node it was reached from
+    for (int v : path) {
+        onRoute[v] = routeStamp;
+        onCandidate[v] = seen;
+        queue.push_back({v, v});
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        auto [u, origin] = queue[head];
+        const glm::vec3& center = graph[origin].position;
+        for (const Edge& e : graph[u].neighbors) {
+            if (onCandidate[e.to] == seen) continue;
+            if (horizontalDistance(center, graph[e.to].position) > width) continue;
+            onCandidate[e.to] = seen;
+            onRoute[e.to] = routeStamp;
+            queue.push_back({e.to, origin});
+        }
+    }
+}
+
+std::vector<AlternativeRoute> AlternativeRouter::find(int startIndex, int goalIndex,
+                                                      const AlternativeOptions& options) {
+    std::vector<AlternativeRoute> routes;
+    settled = 0;
+    forwardOrder.clear();
+    if (onRoute.size() != graph.size()) {
+        onRoute.assign(graph.size(), 0u);
+        onCandidate.assign(graph.size(), 0u);
+    }
+
+    float stretch = std::max(options.maxStretch, 1.0f);
+    float shortest = INF;
+    const glm::vec3 goalPos = graph[goalIndex].position;
+    grow(forward, startIndex, goalIndex, false, shortest, stretch, [&](int v) {
+        return hScale * glm::length(graph[v].position - goalPos);
+    });
+    if (shortest == INF) return routes;
+    // Exact distances from the start bound the backward tree, so it only settles
+    // nodes whose route through them is within the stretch limit
+    float bound = shortest;
+    grow(backward, goalIndex, startIndex, true, bound, stretch, [&](int v) {
+        return forward.isClosed(v) ? forward.dist(v) : INF;
+    });
+
+    // One candidate per plateau: walk each maximal chain of arcs that lie on both trees
+    struct Plateau {
+        float via;     // cost of the route through it
+        float length;  // cost of the plateau itself
+        int node;
+    };
+    std::vector<Plateau> plateaus;
+    float minPlateau = options.minPlateau * shortest;
+    for (int v : forwardOrder) {
+        if (!backward.isClosed(v)) continue;
+        int next = backward.prev(v);
+        if (next == -1 || !forward.isClosed(next) || forward.prev(next) != v) continue;
+        int prev = forward.prev(v);
+        if (prev != -1 && backward.isClosed(prev) && backward.prev(prev) == v) continue; // not the first node
+
+        int end = next;
+        for (int n = backward.prev(end); n != -1 && forward.isClosed(n) && forward.prev(n) == end;
+             n = backward.prev(end)) {
+            end = n;
+        }
+        float length = forward.dist(end) - forward.dist(v);
+        if (length >= minPlateau) plateaus.push_back({forward.dist(v) + backward.dist(v), length, v});
+    }
+    std::sort(plateaus.begin(), plateaus.end(), [](const Plateau& a, const Plateau& b) {
+        return a.via != b.via ? a.via < b.via : a.length > b.length;
+    });
+
+    uint32_t routeStamp = nextStamp();
+    auto accept = [&](std::vector<int> path, float shared) {
+        AlternativeRoute route;
+        route.stats = routeStats(graph, path);
+        route.stretch = route.stats.cost / shortest;
+        route.shared = shared / shortest;
+        route.path = std::move(path);
+        markCorridor(route.path, options.corridor, routeStamp);
+        routes.push_back(std::move(route));
+    };
+
+    // The shortest route comes from the forward tree: with cost ties the two
+    // trees may disagree on it and split its plateau into pieces
+    accept(forward.pathTo(goalIndex), 0.0f);
+
+    std::vector<int> path;
+    for (const Plateau& p : plateaus) {
+        if ((int)routes.size() >= options.maxRoutes) break;
+        if (p.via > stretch * shortest) break;
+
+        // start -> p.node along the forward tree, then on to the goal along the backward tree
+        uint32_t candidate = nextStamp();
+        path.clear();
+        for (int v = p.node; v != -1; v = forward.prev(v)) {
+            path.push_back(v);
+            onCandidate[v] = candidate;
+        }
+        std::reverse(path.begin(), path.end());
+        bool loop = false;
+        for (int v = backward.prev(p.node); v != -1; v = backward.prev(v)) {
+            if (onCandidate[v] == candidate) {
+                loop = true;
+                break;
+            }
+            path.push_back(v);
+        }
+        if (loop) continue;
+
+        float shared = 0.0f;
+        for (size_t i = 0; i + 1 < path.size(); ++i) {
+            if (onRoute[path[i]] == routeStamp && onRoute[path[i+1]] == routeStamp) {
+                shared += arcCost(path[i], path[i+1]);
+            }
+        }
+        if (shared > options.maxShare * shortest) continue;
+        accept(path, shared);
+    }
+    return routes;
+}
@@ -0,0 +1,134 @@
+#include "anytime.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+AnytimePathfinder::AnytimePathfinder(const std::vector<Node>& g, int s, int goal,
+                                     float initialWeight, float weightStep)
+    : graph(g), startIndex(s), goalIndex(goal),
+      epsilon(std::max(1.0f, initialWeight)), epsilonStep(std::max(weightStep, 0.0f)),
+      solutionCost(INF), solutionBound(INF)
+{
+    hScale = heuristicScale(graph);
+    this->g.assign(graph.size(), INF);
+    parent.assign(graph.size(), -1);
+    closedIn.assign(graph.size(), 0);
+    inconsIn.assign(graph.size(), 0);
+    open.reset(graph.size());
+
+    this->g[startIndex] = 0.0f;
+    open.push(startIndex, epsilon * heuristic(startIndex));
+}
+
+float AnytimePathfinder::heuristic(int v) const {
+    return hScale * glm::length(graph[v].position - graph[goalIndex].position);
+}
+
+bool AnytimePathfinder::iterationDone() const {
+    // ARA* stops an iteration once nothing queued can beat the goal's f value
+    return open.empty() || !(g[goalIndex] > open.minKey());
+}
+
+void AnytimePathfinder::expand(int u, SearchState* state) {
+    closedIn[u] = iteration;
+    ++expanded;
+    if (state) state->visited.push_back(u);
+
+    for (const Edge& e : graph[u].neighbors) {
+        float tentative_g = g[u] + e.cost;
+        if (tentative_g >= g[e.to]) continue;
+        g[e.to] = tentative_g;
+        parent[e.to] = u;
+        if (closedIn[e.to] != iteration) {
+            open.push(e.to, tentative_g + epsilon * heuristic(e.to));
+            if (state) state->frontier.push_back(e.to);
+        } else if (inconsIn[e.to] != iteration) {
+            // Already expanded with a worse g; repaired in the next iteration
+            inconsIn[e.to] = iteration;
+            incons.push_back(e.to);
+        }
+    }
+}
+
+bool AnytimePathfinder::finishIteration() {
+    // Everything still queued or inconsistent, with unweighted f for the bound
+    std::vector<int> pending;
+    pending.reserve(open.size() + incons.size());
+    while (!open.empty()) pending.push_back(open.pop());
+    pending.insert(pending.end(), incons.begin(), incons.end()); // closed, so never also in OPEN
+    incons.clear();
+
+    bool improved = false;
+    if (g[goalIndex] < solutionCost) {
+        solution.clear();
+        for (int v = goalIndex; v != -1; v = parent[v]) solution.push_back(v);
+        std::reverse(solution.begin(), solution.end());
+        solutionCost = g[goalIndex];
+        ++published;
+        improved = true;
+    }
+
+    float lowest = INF;
+    for (int v : pending) lowest = std::min(lowest, g[v] + heuristic(v));
+    float proven = lowest > 0.0f ? solutionCost / lowest : epsilon;
+    solutionBound = std::max(1.0f, std::min(epsilon, proven));
+
+    if (epsilon <= 1.0f || solutionBound <= 1.0f) {
+        done = solutionCost < INF || pending.empty();
+        if (done) {
+            solutionBound = 1.0f;
+            return improved;
+        }
+    }
+
+    // Next iteration: lower weight, empty CLOSED (new stamp), requeue OPEN and INCONS
+    epsilon = std::max(1.0f, epsilon - epsilonStep);
+    if (epsilonStep <= 0.0f) epsilon = 1.0f;
+    ++iteration;
+    for (int v : pending) open.push(v, g[v] + epsilon * heuristic(v));
+    return improved;
+}
+
+bool AnytimePathfinder::step(SearchState& state) {
+    state.frontier.clear();
+    if (done) return false;
+
+    if (iterationDone()) {
+        if (finishIteration()) state.path = solution;
+        return !done;
+    }
+
+    int u = open.pop();
+    expand(u, &state);
+    return true;
+}
+
+bool AnytimePathfinder::improve(size_t maxExpansions, double maxMs) {
+    auto t0 = std::chrono::steady_clock::now();
+    size_t before = published, budgetEnd = expanded + maxExpansions;
+    while (!done) {
+        if (iterationDone()) {
+            finishIteration();
+            continue;
+        }
+        if (maxExpansions > 0 && expanded >= budgetEnd) break;
+        // maxMs is a slice of the render frame and expansions are cheap, so the clock is
+        // read on every 256th (counted across calls): at most 255 expansions over budget
+        if (maxMs > 0.0 && (expanded & 255) == 0 &&
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() >= maxMs) {
+            break;
+        }
+        expand(open.pop(), nullptr);
+    }
+    return published != before;
+}
+
+std::vector<int> AnytimePathfinder::currentBestPath(int target) const {
+    std::vector<int> path;
+    if (g[target] == INF) return path;
+    for (int v = target; v != -1; v = parent[v]) path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
@@ -0,0 +1,85 @@
+#include "async_search.h"
+#include <chrono>
+
+AsyncSearch::AsyncSearch(SteppableSearch& search, size_t stepsPerTick, double tickMs)
+    : search(search), stepsPerTick(stepsPerTick > 0 ? stepsPerTick : 1), tickMs(tickMs)
+{
+    worker = std::thread(&AsyncSearch::run, this);
+}
+
+AsyncSearch::~AsyncSearch() {
+    stop();
+}
+
+void AsyncSearch::stop() {
+    stopRequested.store(true, std::memory_order_release);
+    if (worker.joinable()) worker.join();
+}
+
+void AsyncSearch::wait() {
+    if (worker.joinable()) worker.join();
+}
+
+void AsyncSearch::run() {
+    SearchState state;
+    std::vector<int> parents;   // one per entry of state.visited
+    size_t steps = 0;
+    bool more = true;
+
+    while (more && !stopRequested.load(std::memory_order_acquire)) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < stepsPerTick && more; ++n) {
+            more = search.step(state);
+            ++steps;
+            // A later step may re-parent a node, so record it as it is expanded
+            while (parents.size() < state.visited.size()) {
+                parents.push_back(search.parentOf(state.visited[parents.size()]));
+            }
+            // The tick is the worker's publish cadence; checking every 64th step keeps the
+            // clock off the per-step path and overruns it by at most 63 steps
+            if (tickMs > 0.0 && (n & 63) == 63 &&
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() >= tickMs) {
+                break;
+            }
+        }
+
+        std::vector<int> best = !state.path.empty() ? state.path
+                              : state.visited.empty() ? std::vector<int>()
+                              : search.currentBestPath(state.visited.back());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.visited.insert(pending.visited.end(), state.visited.begin(), state.visited.end());
+            pending.parents.insert(pending.parents.end(), parents.begin(), parents.end());
+            pending.frontier = state.frontier;
+            if (!best.empty()) pending.bestPath.swap(best);
+            pending.steps = steps;
+            pending.finished = !more;
+            hasPending = true;
+        }
+        // Only new expansions are published, so the worker's copy can go
+        state.visited.clear();
+        parents.clear();
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+}
+
+bool AsyncSearch::poll(SearchUpdate& out) {
+    std::vector<int> fresh, freshParents;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!hasPending) return false;
+        fresh.swap(pending.visited);
+        freshParents.swap(pending.parents);
+        out.frontier.swap(pending.frontier);
+        if (!pending.bestPath.empty()) out.bestPath.swap(pending.bestPath); // keep the last one otherwise
+        out.steps = pending.steps;
+        out.finished = pending.finished;
+        pending.frontier.clear();
+        pending.bestPath.clear();
+        hasPending = false;
+    }
+    out.visited.insert(out.visited.end(), fresh.begin(), fresh.end());
+    out.parents.insert(out.parents.end(), freshParents.begin(), freshParents.end());
+    return true;
+}
@@ -0,0 +1,1064 @@
+// Headless benchmarks for the terrain/search code (no window or GL context needed)
+// Usage: PeakGenBench [section|all] [gridSize] [seed]
+// ("ch" only runs when named: contracting the default 513^2 map takes minutes)
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <functional>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "terrain.h"
+#include "pathfinding.h"
+#include "open_set.h"
+#include "bidirectional.h"
+#include "hpa.h"
+#include "contraction.h"
+#include "landmarks.h"
+#include "query_engine.h"
+#include "incremental.h"
+#include "flow_field.h"
+#include "delta_stepping.h"
+#include "anytime.h"
+#include "async_search.h"
+#include "cost_models.h"
+#include "edge_attributes.h"
+#include "alternatives.h"
+#include "peaks.h"
+#include "viewshed.h"
+#include "hydrology.h"
+#include "contours.h"
+#include "horizon.h"
+#include "parallel.h"
+
+// Fixed-seed map shared by all sections
+struct BenchMap {
+    int N = 0;
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<glm::vec3> positions;
+    std::vector<Node> graph;
+    int peakIndex = 0;
+};
+
+struct Query {
+    int start;
+    int goal;
+};
+
+static double elapsedMs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+static BenchMap makeMap(int N, uint32_t seed) {
+    BenchMap map;
+    map.N = N;
+    generateTerrain(N, map.vertices, map.indices, seed);
+    map.positions.reserve(map.vertices.size() / 3);
+    for (size_t i = 0; i < map.vertices.size() / 3; ++i) {
+        map.positions.emplace_back(map.vertices[3*i], map.vertices[3*i+1], map.vertices[3*i+2]);
+    }
+    map.graph = buildGraph(map.positions, map.indices);
+    for (int i = 1; i < (int)map.positions.size(); ++i) {
+        if (map.positions[i].y > map.positions[map.peakIndex].y) map.peakIndex = i;
+    }
+    return map;
+}
+
+// Vertex positions of a fixed-seed (N+1)^2 terrain, for sections that time a bigger
+// grid than the shared map; indices, when given, receives its triangles
+static std::vector<glm::vec3> terrainPositions(int N, uint32_t seed, std::vector<unsigned int>* indices = nullptr) {
+    std::vector<float> vertices;
+    std::vector<unsigned int> triangles;
+    generateTerrain(N, vertices, triangles, seed);
+    std::vector<glm::vec3> positions(vertices.size() / 3);
+    for (size_t i = 0; i < positions.size(); ++i) {
+        positions[i] = glm::vec3(vertices[3*i], vertices[3*i+1], vertices[3*i+2]);
+    }
+    if (indices) *indices = std::move(triangles);
+    return positions;
+}
+
+// Four corners to the summit plus a fixed set of random pairs
+static std::vector<Query> makeQueries(const BenchMap& map, int randomCount) {
+    int side = map.N + 1;
+    std::vector<Query> queries = {
+        {0, map.peakIndex},
+        {side - 1, map.peakIndex},
+        {side * (side - 1), map.peakIndex},
+        {side * side - 1, map.peakIndex},
+    };
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> pick(0, side * side - 1);
+    for (int i = 0; i < randomCount; ++i) queries.push_back({pick(rng), pick(rng)});
+    return queries;
+}
+
+// ---------------------------------------------------------------------------
+// Open-set policies: pushes/pops and peak queue memory per policy
+
+template <class OpenSet>
+static void runOpenSet(const char* name, const BenchMap& map, const std::vector<Query>& queries, OpenSet openSet) {
+    SearchWorkspace ws(map.graph.size());
+    size_t peakSize = 0, peakBytes = 0, pathNodes = 0;
+    OpenSetStats total;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (const Query& q : queries) {
+        openSet.stats = OpenSetStats();
+        pathNodes += findPathWith(map.graph, q.start, q.goal, ws, openSet).size();
+        total.pushes += openSet.stats.pushes;
+        total.decreases += openSet.stats.decreases;
+        total.pops += openSet.stats.pops;
+        peakSize = std::max(peakSize, openSet.stats.peakSize);
+        peakBytes = std::max(peakBytes, openSet.stats.peakBytes);
+    }
+    double ms = elapsedMs(t0);
+
+    std::printf("  %-14s %9.2f ms %11zu push %10zu dec %11zu pop %9zu peak %9.1f KiB  (path nodes %zu)\n",
+                name, ms, total.pushes, total.decreases, total.pops, peakSize, peakBytes / 1024.0, pathNodes);
+}
+
+static void benchOpenSets(const BenchMap& map) {
+    auto queries = makeQueries(map, 60);
+    std::printf("open sets: %zu queries\n", queries.size());
+    runOpenSet("binary (lazy)", map, queries, BinaryHeapOpenSet());
+    runOpenSet("4-ary indexed", map, queries, QuaternaryHeapOpenSet());
+    runOpenSet("radix", map, queries, RadixHeapOpenSet());
+}
+
+// ---------------------------------------------------------------------------
+// Bidirectional vs unidirectional A* (same consistent heuristic) on summit routes
+
+static void benchBidirectional(const BenchMap& map) {
+    auto queries = makeQueries(map, 12);
+    float scale = heuristicScale(map.graph);
+    SearchWorkspace ws(map.graph.size()), fwd(map.graph.size()), bwd(map.graph.size());
+    std::printf("bidirectional: heuristic scale %.3f\n", scale);
+
+    size_t uniTotal = 0, biTotal = 0;
+    double uniMs = 0.0, biMs = 0.0;
+    for (const Query& q : queries) {
+        QuaternaryHeapOpenSet open;
+        auto t0 = std::chrono::steady_clock::now();
+        auto uni = findPathWith(map.graph, q.start, q.goal, ws, open, scale);
+        uniMs += elapsedMs(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        BidirectionalPathfinder bi(map.graph, q.start, q.goal, scale, fwd, bwd);
+        auto biPath = bi.run();
+        biMs += elapsedMs(t0);
+
+        uniTotal += open.stats.pops;
+        biTotal += bi.expandedCount();
+        std::printf("  %7d -> %-7d  uni %8zu exp  cost %9.3f | bi %8zu exp  cost %9.3f\n",
+                    q.start, q.goal, open.stats.pops, pathCost(map.graph, uni),
+                    bi.expandedCount(), pathCost(map.graph, biPath));
+    }
+    std::printf("  total expanded: uni %zu (%.1f ms), bi %zu (%.1f ms), ratio %.2f\n",
+                uniTotal, uniMs, biTotal, biMs, uniTotal ? (double)biTotal / uniTotal : 0.0);
+}
+
+// ---------------------------------------------------------------------------
+// HPA*: preprocessing, query latency and suboptimality against exact search
+
+static void benchHierarchical(const BenchMap& map) {
+    auto queries = makeQueries(map, 60);
+    float scale = heuristicScale(map.graph);
+    SearchWorkspace fwd(map.graph.size()), bwd(map.graph.size());
+
+    for (int clusterSize : {16, 32, 64}) {
+        auto t0 = std::chrono::steady_clock::now();
+        HierarchicalPathfinder hpa(map.graph, map.N + 1, clusterSize, clusterSize / 4);
+        double buildMs = elapsedMs(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        hpa.updateCluster(hpa.clusterOf(map.peakIndex));
+        double updateMs = elapsedMs(t0);
+
+        double queryMs = 0.0, exactMs = 0.0, worst = 1.0, sum = 0.0;
+        size_t expanded = 0;
+        for (const Query& q : queries) {
+            HpaQueryStats stats;
+            t0 = std::chrono::steady_clock::now();
+            hpa.findPath(q.start, q.goal, &stats);
+            queryMs += elapsedMs(t0);
+            expanded += stats.abstractExpanded + stats.refineExpanded;
+
+            t0 = std::chrono::steady_clock::now();
+            BidirectionalPathfinder exact(map.graph, q.start, q.goal, scale, fwd, bwd);
+            exact.run();
+            exactMs += elapsedMs(t0);
+            double ratio = exact.bestCost() > 0.0f ? stats.cost / exact.bestCost() : 1.0;
+            worst = std::max(worst, ratio);
+            sum += ratio;
+        }
+        std::printf("hpa cluster %2d: build %8.1f ms, %6zu abstract nodes, %8zu abstract edges, update %.2f ms\n",
+                    clusterSize, buildMs, hpa.abstractNodeCount(), hpa.abstractEdgeCount(), updateMs);
+        std::printf("               query avg %.3f ms (exact %.3f ms), %zu expanded/query, cost ratio vs exact: mean %.4f max %.4f\n",
+                    queryMs / queries.size(), exactMs / queries.size(), expanded / queries.size(),
+                    sum / queries.size(), worst);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Contraction hierarchy: preprocessing cost, shortcut count and exact query latency
+
+static void benchContraction(const BenchMap& map) {
+    ContractionHierarchy ch(map.graph);
+    const ContractionStats& st = ch.stats();
+    std::printf("ch: preprocess %.1f ms (%zu rounds), %zu edges + %zu shortcuts, %zu upward edges\n",
+                st.preprocessMs, st.rounds, st.originalEdges, st.shortcuts, st.upwardEdges);
+
+    auto queries = makeQueries(map, 200);
+    float scale = heuristicScale(map.graph);
+    SearchWorkspace fwd(map.graph.size()), bwd(map.graph.size());
+
+    double chUs = 0.0, exactUs = 0.0;
+    size_t settled = 0, mismatches = 0;
+    for (const Query& q : queries) {
+        float cost = 0.0f;
+        auto t0 = std::chrono::steady_clock::now();
+        auto path = ch.findPath(q.start, q.goal, &cost);
+        chUs += elapsedMs(t0) * 1000.0;
+        settled += ch.lastSettled();
+
+        t0 = std::chrono::steady_clock::now();
+        BidirectionalPathfinder exact(map.graph, q.start, q.goal, scale, fwd, bwd);
+        exact.run();
+        exactUs += elapsedMs(t0) * 1000.0;
+        float unpacked = pathCost(map.graph, path);
+        if (std::abs(unpacked - exact.bestCost()) > 1e-3f * exact.bestCost()) ++mismatches;
+    }
+    std::printf("    query avg %.1f us (bidirectional A* %.1f us), %zu settled/query, %zu/%zu costs differ from exact\n",
+                chUs / queries.size(), exactUs / queries.size(), settled / queries.size(), mismatches,
+                queries.size());
+}
+
+// ---------------------------------------------------------------------------
+// ALT vs Euclidean A*: expansions for optimal routes, and what the 15x weight costs
+
+static void benchLandmarks(const BenchMap& map) {
+    auto queries = makeQueries(map, 60);
+    float scale = heuristicScale(map.graph);
+    SearchWorkspace ws(map.graph.size());
+
+    for (int count : {4, 8, 16}) {
+        LandmarkTable landmarks(map.graph, count);
+
+        size_t euclidExp = 0, altExp = 0, weightedExp = 0, altWrong = 0;
+        double euclidMs = 0.0, altMs = 0.0, weightedCost = 0.0, optimalCost = 0.0;
+        for (const Query& q : queries) {
+            QuaternaryHeapOpenSet open;
+            auto t0 = std::chrono::steady_clock::now();
+            float exact = pathCost(map.graph, findPathWith(map.graph, q.start, q.goal, ws, open, scale));
+            euclidMs += elapsedMs(t0);
+            euclidExp += open.stats.pops;
+
+            ws.openSet.stats = OpenSetStats();
+            t0 = std::chrono::steady_clock::now();
+            float alt = pathCost(map.graph, findPathALT(map.graph, landmarks, q.start, q.goal, ws));
+            altMs += elapsedMs(t0);
+            altExp += ws.openSet.stats.pops;
+            if (std::abs(alt - exact) > 1e-3f * exact) ++altWrong;
+
+            QuaternaryHeapOpenSet weightedOpen;
+            weightedCost += pathCost(map.graph, findPathWith(map.graph, q.start, q.goal, ws, weightedOpen));
+            weightedExp += weightedOpen.stats.pops;
+            optimalCost += exact;
+        }
+        std::printf("alt %2d landmarks: build %.1f ms | expanded euclid %zu (%.1f ms), alt %zu (%.1f ms), "
+                    "ratio %.2f, %zu non-optimal\n",
+                    count, landmarks.buildMs(), euclidExp, euclidMs, altExp, altMs,
+                    euclidExp ? (double)altExp / euclidExp : 0.0, altWrong);
+        if (count == 4) {
+            std::printf("    15x weighted: %zu expanded, cost %.1f%% above optimal\n",
+                        weightedExp, 100.0 * (weightedCost / optimalCost - 1.0));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Batch query engine: throughput and latency percentiles per thread count
+
+static void benchBatch(const BenchMap& map) {
+    std::vector<RouteQuery> batch;
+    for (const Query& q : makeQueries(map, 252)) batch.push_back({q.start, q.goal});
+    LandmarkTable landmarks(map.graph);
+
+    std::vector<RouteResult> reference;
+    std::vector<int> counts = {1, 2, 4, hardwareThreads()};
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    std::printf("batch: %zu queries, ALT with %zu landmarks\n", batch.size(), landmarks.landmarks().size());
+    for (int threads : counts) {
+        RouteQueryEngine engine(map.graph, landmarks, threads);
+        BatchStats st;
+        auto results = engine.run(batch, &st);
+        if (reference.empty()) reference = results;
+
+        size_t differ = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (std::abs(results[i].cost - reference[i].cost) > 1e-4f * reference[i].cost) ++differ;
+        }
+        std::printf("  %2d threads: %8.1f ms, %8.1f queries/s | latency p50 %.2f p90 %.2f p99 %.2f max %.2f ms"
+                    " | %zu costs differ from 1 thread\n",
+                    st.threads, st.wallMs, st.queriesPerSecond, st.p50Ms, st.p90Ms, st.p99Ms, st.maxMs, differ);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// LPA*: cost of repairing the plan after a local height edit vs a fresh search
+
+static void benchIncremental(const BenchMap& map) {
+    const int side = map.N + 1;
+    std::vector<Node> graph = map.graph; // edited below
+    float scale = heuristicScale(graph);
+    SearchWorkspace ws(graph.size());
+
+    IncrementalPathfinder planner(graph, 0, map.peakIndex);
+    auto t0 = std::chrono::steady_clock::now();
+    auto path = planner.run();
+    std::printf("lpa: initial plan %.1f ms, %zu expanded, cost %.3f\n",
+                elapsedMs(t0), planner.expandedCount(), planner.cost());
+
+    std::mt19937 rng(99);
+    size_t repairTotal = 0, scratchTotal = 0, mismatches = 0;
+    double repairMs = 0.0, scratchMs = 0.0;
+    const int edits = 20, radius = 3;
+    for (int k = 0; k < edits; ++k) {
+        // Raise or dig a small disc on the current route
+        int center = path[std::uniform_int_distribution<size_t>(0, path.size() - 1)(rng)];
+        float delta = k % 2 == 0 ? 0.05f : -0.03f;
+        int ci = center / side, cj = center % side;
+        std::vector<EdgeChange> changes;
+        for (int i = std::max(0, ci - radius); i <= std::min(side - 1, ci + radius); ++i) {
+            for (int j = std::max(0, cj - radius); j <= std::min(side - 1, cj + radius); ++j) {
+                int v = i * side + j;
+                auto c = setNodeHeight(graph, v, graph[v].position.y + delta);
+                changes.insert(changes.end(), c.begin(), c.end());
+            }
+        }
+
+        size_t before = planner.expandedCount();
+        t0 = std::chrono::steady_clock::now();
+        planner.edgesChanged(changes);
+        path = planner.run();
+        repairMs += elapsedMs(t0);
+        repairTotal += planner.expandedCount() - before;
+
+        QuaternaryHeapOpenSet open;
+        t0 = std::chrono::steady_clock::now();
+        float exact = pathCost(graph, findPathWith(graph, 0, map.peakIndex, ws, open, scale));
+        scratchMs += elapsedMs(t0);
+        scratchTotal += open.stats.pops;
+        if (std::abs(exact - planner.cost()) > 1e-3f * exact ||
+            std::abs(pathCost(graph, path) - exact) > 1e-3f * exact) ++mismatches;
+    }
+    std::printf("    %d edits (radius %d): repair %zu expanded (%.2f ms), fresh A* %zu expanded (%.2f ms),"
+                " ratio %.3f, %d/%d costs differ from fresh\n",
+                edits, radius, repairTotal / edits, repairMs / edits, scratchTotal / edits, scratchMs / edits,
+                scratchTotal ? (double)repairTotal / scratchTotal : 0.0, (int)mismatches, edits);
+}
+
+// ---------------------------------------------------------------------------
+// Flow field: one reverse search to the summit vs one A* per start
+
+static void benchFlowField(const BenchMap& map) {
+    const int side = map.N + 1;
+    const int starts = 1000;
+    std::mt19937 rng(4321);
+    std::uniform_int_distribution<int> pick(0, side * side - 1);
+    std::vector<int> from(starts);
+    for (int& v : from) v = pick(rng);
+
+    FlowField field(map.graph, map.peakIndex);
+
+    size_t hops = 0, mismatches = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int s : from) hops += field.routeFrom(s).size();
+    double walkMs = elapsedMs(t0);
+
+    // Per-start A* on a subset; extrapolate the total
+    const int sampled = 50;
+    float scale = heuristicScale(map.graph);
+    SearchWorkspace ws(map.graph.size());
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < sampled; ++i) {
+        QuaternaryHeapOpenSet open;
+        float exact = pathCost(map.graph, findPathWith(map.graph, from[i], map.peakIndex, ws, open, scale));
+        float walked = pathCost(map.graph, field.routeFrom(from[i]));
+        if (std::abs(exact - walked) > 1e-3f * exact || std::abs(field.costToGoal(from[i]) - exact) > 1e-3f * exact) {
+            ++mismatches;
+        }
+    }
+    double astarMs = elapsedMs(t0) * starts / sampled;
+
+    std::printf("flow field: build %.1f ms, %d routes walked in %.2f ms (%.1f hops avg) | per-start A* ~%.0f ms,"
+                " %zu/%d sampled costs differ\n",
+                field.buildMs(), starts, walkMs, (double)hops / starts, astarMs, mismatches, sampled);
+}
+
+// ---------------------------------------------------------------------------
+// Delta-stepping: whole-map cost field vs sequential Dijkstra, scaling and delta tuning
+
+static void benchDeltaStepping(const BenchMap& map) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<float> reference = shortestDistances(map.graph, map.peakIndex);
+    double dijkstraMs = elapsedMs(t0);
+    float suggested = DeltaStepping::suggestDelta(map.graph);
+    std::printf("delta-stepping: dijkstra %.1f ms, suggested delta %.3f\n", dijkstraMs, suggested);
+
+    auto check = [&](const std::vector<float>& dist) {
+        size_t differ = 0;
+        for (size_t v = 0; v < dist.size(); ++v) differ += dist[v] != reference[v];
+        return differ;
+    };
+
+    std::vector<int> counts = {1, 2, 4, 8, hardwareThreads()};
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    for (int threads : counts) {
+        DeltaStepping engine(map.graph, suggested, threads);
+        auto dist = engine.distances(map.peakIndex);
+        const DeltaSteppingStats& st = engine.lastStats();
+        std::printf("  %2d threads: %8.1f ms (%.2fx dijkstra), %zu buckets, %zu phases, %zu relaxations,"
+                    " %zu differ\n", threads, st.ms, dijkstraMs / st.ms, st.buckets, st.phases,
+                    st.relaxations, check(dist));
+    }
+    for (float factor : {0.5f, 2.0f, 4.0f}) {
+        DeltaStepping engine(map.graph, suggested * factor, hardwareThreads());
+        auto dist = engine.distances(map.peakIndex);
+        const DeltaSteppingStats& st = engine.lastStats();
+        std::printf("  delta x%.1f (%.3f): %8.1f ms, %zu phases, %zu relaxations, %zu differ\n",
+                    factor, engine.delta(), st.ms, st.phases, st.relaxations, check(dist));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ARA*: time to the first route, how the bound tightens, and time to optimal
+
+static void benchAnytime(const BenchMap& map) {
+    auto queries = makeQueries(map, 4);
+    float scale = heuristicScale(map.graph);
+    SearchWorkspace ws(map.graph.size());
+    std::printf("ara*: initial weight 3, step 0.5\n");
+
+    for (const Query& q : queries) {
+        QuaternaryHeapOpenSet open;
+        auto t0 = std::chrono::steady_clock::now();
+        float optimal = pathCost(map.graph, findPathWith(map.graph, q.start, q.goal, ws, open, scale));
+        double astarMs = elapsedMs(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        AnytimePathfinder ara(map.graph, q.start, q.goal);
+        std::printf("  %7d -> %-7d optimal %8.3f, A* %zu exp %.1f ms\n", q.start, q.goal, optimal,
+                    open.stats.pops, astarMs);
+        while (!ara.converged()) {
+            // 20k expansions per frame-sized slice
+            if (!ara.improve(20000)) continue;
+            std::printf("      %8.1f ms %8zu exp: weight %.2f cost %8.3f (+%.2f%%) bound %.3f%s\n",
+                        elapsedMs(t0), ara.expandedCount(), ara.weight(), ara.bestCost(),
+                        100.0 * (ara.bestCost() / optimal - 1.0), ara.bound(),
+                        ara.bestCost() > ara.bound() * optimal * 1.0001f ? "  BOUND VIOLATED" : "");
+        }
+        std::printf("      converged in %.1f ms, %zu expanded\n", elapsedMs(t0), ara.expandedCount());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Async search: solve time on the worker vs inline, and what a poll costs the render thread
+
+static void benchAsync(const BenchMap& map) {
+    float scale = heuristicScale(map.graph);
+    int start = 0;
+
+    // Inline, the way the render loop used to drive it (minus the 0.1 s throttle)
+    SearchWorkspace ws(map.graph.size());
+    QuaternaryHeapOpenSet open;
+    auto t0 = std::chrono::steady_clock::now();
+    findPathWith(map.graph, start, map.peakIndex, ws, open, scale);
+    std::printf("async: inline A* %.1f ms, %zu expanded\n", elapsedMs(t0), open.stats.pops);
+
+    for (size_t perTick : {256, 4096, 65536}) {
+        LandmarkTable landmarks(map.graph, 8);
+        Pathfinder pf(map.graph, start, map.peakIndex, landmarks);
+        SearchUpdate update;
+        std::vector<double> pollUs;
+
+        t0 = std::chrono::steady_clock::now();
+        AsyncSearch search(pf, perTick);
+        while (!update.finished) {
+            auto p0 = std::chrono::steady_clock::now();
+            search.poll(update);
+            pollUs.push_back(elapsedMs(p0) * 1000.0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2)); // stand-in for a frame
+        }
+        double solveMs = elapsedMs(t0);
+        std::sort(pollUs.begin(), pollUs.end());
+        std::printf("  %6zu steps/tick: solved in %.1f ms, %zu expansions, %zu polls,"
+                    " poll p50 %.1f us p99 %.1f us max %.1f us, path %zu nodes\n",
+                    perTick, solveMs, update.visited.size(), pollUs.size(), pollUs[pollUs.size() / 2],
+                    pollUs[pollUs.size() * 99 / 100], pollUs.back(), update.bestPath.size());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Cost policies: inlined templates vs stored costs vs std::function dispatch
+
+// Plain A* loop calling the out-of-line edgeCost(): the baseline the policies must match
+static std::vector<int> handWrittenSlopeSearch(const std::vector<Node>& graph, int start, int goal,
+                                               SearchWorkspace& ws, const SlopeCost& bound) {
+    const glm::vec3 goalPos = graph[goal].position;
+    ws.beginQuery(graph.size());
+    ws.openSet.reset(graph.size());
+    ws.set(start, 0.0f, -1);
+    ws.openSet.push(start, bound.lowerBound(graph[start].position, goalPos));
+    while (!ws.openSet.empty()) {
+        int u = ws.openSet.pop();
+        if (ws.isClosed(u)) continue;
+        ws.close(u);
+        if (u == goal) break;
+        for (const Edge& e : graph[u].neighbors) {
+            float tentative_g = ws.dist(u) + edgeCost(graph[u].position, graph[e.to].position);
+            if (tentative_g < ws.dist(e.to)) {
+                ws.set(e.to, tentative_g, u);
+                if (ws.isClosed(e.to)) continue;
+                ws.openSet.push(e.to, tentative_g + bound.lowerBound(graph[e.to].position, goalPos));
+            }
+        }
+    }
+    return ws.pathTo(goal);
+}
+
+static void benchCostPolicies(const BenchMap& map) {
+    auto queries = makeQueries(map, 28);
+    SearchWorkspace ws(map.graph.size());
+    SlopeCost slope;
+    slope.maxStep = maxHorizontalStep(map.graph);
+
+    // Best of three passes over all queries; returns total path cost
+    auto timed = [&](const char* name, auto&& search) {
+        double best = 1e30;
+        float total = 0.0f;
+        size_t expanded = 0;
+        for (int pass = 0; pass < 3; ++pass) {
+            total = 0.0f;
+            ws.openSet.stats = OpenSetStats();
+            auto t0 = std::chrono::steady_clock::now();
+            for (const Query& q : queries) total += search(q);
+            best = std::min(best, elapsedMs(t0));
+            expanded = ws.openSet.stats.pops;
+        }
+        std::printf("  %-30s %9.1f ms  %9zu expanded  total cost %.3f\n", name, best, expanded, total);
+        return total;
+    };
+
+    std::printf("cost policies: %zu queries, best of 3\n", queries.size());
+    float baseline = timed("hand-written, edgeCost()", [&](const Query& q) {
+        return pathCost(map.graph, handWrittenSlopeSearch(map.graph, q.start, q.goal, ws, slope));
+    });
+    float policy = timed("SlopeCost policy (template)", [&](const Query& q) {
+        return pathCost(map.graph, findPathModel(map.graph, q.start, q.goal, ws, slope));
+    });
+    timed("SlopeCost via std::function", [&](const Query& q) {
+        const glm::vec3 goal = map.graph[q.goal].position;
+        std::function<float(int, const Edge&)> weightOf = [&](int u, const Edge& e) {
+            return slope(map.graph[u].position, map.graph[e.to].position);
+        };
+        std::function<float(int)> estimate = [&](int v) { return slope.lowerBound(map.graph[v].position, goal); };
+        return pathCost(map.graph, findPathWithCosts(map.graph, q.start, q.goal, ws, ws.openSet, weightOf, estimate));
+    });
+    float stored = timed("stored costs, SlopeCost bound", [&](const Query& q) {
+        const glm::vec3 goal = map.graph[q.goal].position;
+        return pathCost(map.graph, findPathWithHeuristic(map.graph, q.start, q.goal, ws, ws.openSet,
+            [&](int v) { return slope.lowerBound(map.graph[v].position, goal); }));
+    });
+    std::printf("  route costs %s\n", baseline == policy && policy == stored ? "identical" : "DIFFER");
+
+    ToblerCost tobler;
+    EnergyCost energy;
+    timed("ToblerCost policy (hours)", [&](const Query& q) {
+        findPathModel(map.graph, q.start, q.goal, ws, tobler);
+        return ws.dist(q.goal);
+    });
+    timed("EnergyCost policy", [&](const Query& q) {
+        findPathModel(map.graph, q.start, q.goal, ws, energy);
+        return ws.dist(q.goal);
+    });
+}
+
+// ---------------------------------------------------------------------------
+// Cost profiles over stored edge attributes: switching cost vs a graph rebuild
+
+static void benchProfiles(const BenchMap& map) {
+    auto t0 = std::chrono::steady_clock::now();
+    EdgeAttributes attributes(map.graph);
+    double attrMs = elapsedMs(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    std::vector<Node> rebuilt = buildGraph(map.positions, map.indices);
+    double rebuildMs = elapsedMs(t0);
+
+    CostProfile hiker;
+    CostProfile runner;
+    runner.base = 0.5f; runner.perLength = 200.0f; runner.uphill = 6.0f; runner.downhill = 1.0f;
+    CostProfile packAnimal;
+    packAnimal.uphill = 4.0f; packAnimal.downhill = 4.0f; packAnimal.climb = 20.0f; packAnimal.maxGrade = 0.6f;
+
+    std::vector<float> costs;
+    attributes.evaluate(hiker, costs); // warm up
+    double oneMs = 1e30, threeMs = 1e30;
+    std::vector<std::vector<float>> all;
+    for (int pass = 0; pass < 5; ++pass) {
+        t0 = std::chrono::steady_clock::now();
+        attributes.evaluate(hiker, costs);
+        oneMs = std::min(oneMs, elapsedMs(t0));
+        t0 = std::chrono::steady_clock::now();
+        attributes.evaluate({hiker, runner, packAnimal}, all);
+        threeMs = std::min(threeMs, elapsedMs(t0));
+    }
+
+    size_t differ = 0;
+    for (size_t u = 0; u < map.graph.size(); ++u) {
+        for (const Edge& e : map.graph[u].neighbors) differ += costs[attributes.arcIndex((int)u, e)] != e.cost;
+    }
+    std::printf("profiles: %zu arcs, attributes %.1f ms (%.1f MiB) | evaluate 1 profile %.2f ms, 3 in one sweep %.2f ms"
+                " | buildGraph rebuild %.1f ms | default profile vs stored costs: %zu differ\n",
+                attributes.arcCount(), attrMs, attributes.arcCount() * 2 * sizeof(float) / 1048576.0,
+                oneMs, threeMs, rebuildMs, differ);
+
+    auto queries = makeQueries(map, 12);
+    SearchWorkspace ws(map.graph.size());
+    const char* names[] = {"hiker", "runner", "pack animal"};
+    const CostProfile* profiles[] = {&hiker, &runner, &packAnimal};
+    for (int p = 0; p < 3; ++p) {
+        double ms = 0.0, total = 0.0;
+        size_t mismatches = 0, unreachable = 0;
+        std::vector<Node> applied = map.graph;
+        applyCosts(applied, attributes, all[p]);
+        for (const Query& q : queries) {
+            t0 = std::chrono::steady_clock::now();
+            findPathProfile(map.graph, attributes, *profiles[p], all[p], q.start, q.goal, ws);
+            ms += elapsedMs(t0);
+            float cost = ws.isClosed(q.goal) ? ws.dist(q.goal) : std::numeric_limits<float>::infinity();
+            float exact = shortestDistances(applied, q.start)[q.goal];
+            if (!std::isfinite(exact)) { ++unreachable; continue; }
+            total += cost;
+            if (std::abs(cost - exact) > 1e-3f * exact) ++mismatches;
+        }
+        std::printf("  %-12s %zu queries %.1f ms, total cost %.1f, %zu unreachable, %zu differ from Dijkstra\n",
+                    names[p], queries.size(), ms, total, unreachable, mismatches);
+    }
+}
+
+// Alternative routes: cost of K alternatives vs one exact query, and how different they are
+static void benchAlternatives(const BenchMap& map) {
+    auto queries = makeQueries(map, 5);
+    float scale = heuristicScale(map.graph);
+    SearchWorkspace ws(map.graph.size());
+    AlternativeRouter router(map.graph);
+    AlternativeOptions options;
+    std::printf("alternatives: up to %d routes, stretch <= %.2f, share <= %.2f, plateau >= %.2f\n",
+                options.maxRoutes, options.maxStretch, options.maxShare, options.minPlateau);
+
+    for (const Query& q : queries) {
+        auto t0 = std::chrono::steady_clock::now();
+        float optimal = pathCost(map.graph, findPathWith(map.graph, q.start, q.goal, ws, ws.openSet, scale));
+        double astarMs = elapsedMs(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        auto routes = router.find(q.start, q.goal, options);
+        double ms = elapsedMs(t0);
+        std::printf("  %7d -> %-7d A* %.1f ms | %zu routes in %.1f ms (%.1fx one query), %zu settled\n",
+                    q.start, q.goal, astarMs, routes.size(), ms, ms / astarMs, router.lastSettled());
+        for (const AlternativeRoute& r : routes) {
+            const RouteStats& st = r.stats;
+            std::printf("      cost %8.2f (x%.3f) shared %.2f | length %.3f climb %.3f descent %.3f"
+                        " slope mean %.3f max %.3f | %zu nodes%s\n",
+                        st.cost, r.stretch, r.shared, st.length, st.climb, st.descent, st.meanSlope,
+                        st.maxSlope, r.path.size(),
+                        &r == &routes[0] && std::abs(st.cost - optimal) > 1e-3f * optimal ? "  NOT OPTIMAL" : "");
+        }
+    }
+}
+
+// Highest saddle on any route from peak p to higher ground, by a bottleneck search
+// (the definition of the key saddle, for checking the sweep)
+static float keySaddleHeight(const BenchMap& map, int p) {
+    auto higher = [&](int a, int b) {
+        float ha = map.positions[a].y, hb = map.positions[b].y;
+        return ha != hb ? ha > hb : a < b;
+    };
+    std::vector<char> seen(map.graph.size(), 0);
+    std::priority_queue<std::pair<float, int>> queue;   // bottleneck height, node
+    queue.push({map.positions[p].y, p});
+    while (!queue.empty()) {
+        auto [bottleneck, u] = queue.top();
+        queue.pop();
+        if (seen[u]) continue;
+        seen[u] = 1;
+        if (higher(u, p)) return bottleneck;
+        for (const Edge& e : map.graph[u].neighbors) {
+            if (!seen[e.to]) queue.push({std::min(bottleneck, map.positions[e.to].y), e.to});
+        }
+    }
+    return -std::numeric_limits<float>::infinity();
+}
+
+// Peaks and prominence: sweep time by thread count, check against brute force, larger map
+static void benchPeaks(const BenchMap& map) {
+    std::vector<Peak> peaks;
+    for (int threads : {1, 2, 4, hardwareThreads()}) {
+        auto t0 = std::chrono::steady_clock::now();
+        peaks = findPeaks(map.positions, map.indices, 0, threads);
+        std::printf("peaks: %zu local maxima in %.1f ms on %d threads\n", peaks.size(), elapsedMs(t0), threads);
+    }
+
+    // Every strict local maximum (same tie order) must be a peak
+    size_t maxima = 0;
+    for (int v = 0; v < (int)map.graph.size(); ++v) {
+        bool top = true;
+        for (const Edge& e : map.graph[v].neighbors) {
+            float hv = map.positions[v].y, hu = map.positions[e.to].y;
+            if (hu > hv || (hu == hv && e.to < v)) top = false;
+        }
+        maxima += top;
+    }
+    size_t wrong = 0, checked = std::min<size_t>(peaks.size(), 25);
+    for (size_t i = 1; i < checked; ++i) {
+        float saddle = keySaddleHeight(map, peaks[i].vertex);
+        if (std::abs((peaks[i].height - saddle) - peaks[i].prominence) > 1e-6f) ++wrong;
+    }
+    std::printf("  scan finds %zu local maxima; %zu of the top %zu prominences differ from brute force;"
+                " highest is the summit: %s\n", maxima, wrong, checked,
+                !peaks.empty() && peaks[0].vertex == map.peakIndex ? "yes" : "NO");
+    for (size_t i = 0; i < std::min<size_t>(peaks.size(), 8); ++i) {
+        std::printf("    #%zu vertex %7d height %.3f prominence %.3f saddle %d\n", i, peaks[i].vertex,
+                    peaks[i].height, peaks[i].prominence, peaks[i].keySaddle);
+    }
+
+    // Regeneration cost at 4x the vertices (terrain only, no graph)
+    std::vector<unsigned int> indices;
+    std::vector<glm::vec3> positions = terrainPositions(map.N * 2, 2022053872u, &indices);
+    auto t0 = std::chrono::steady_clock::now();
+    auto big = findPeaks(positions, indices, 10);
+    std::printf("  %dx%d (%zu vertices): top %zu of the peaks in %.1f ms\n", map.N * 2 + 1, map.N * 2 + 1,
+                positions.size(), big.size(), elapsedMs(t0));
+}
+
+// Exact line of sight by marching the ray at quarter-cell steps over the bilinear surface
+static bool rayVisible(const std::vector<glm::vec3>& positions, int side, int from, int to, float eyeHeight) {
+    auto heightAt = [&](float fi, float fj) {
+        int i = std::min((int)fi, side - 2), j = std::min((int)fj, side - 2);
+        float ti = fi - i, tj = fj - j;
+        float h00 = positions[i * side + j].y, h01 = positions[i * side + j + 1].y;
+        float h10 = positions[(i + 1) * side + j].y, h11 = positions[(i + 1) * side + j + 1].y;
+        return (h00 * (1 - tj) + h01 * tj) * (1 - ti) + (h10 * (1 - tj) + h11 * tj) * ti;
+    };
+    float ai = float(from / side), aj = float(from % side), bi = float(to / side), bj = float(to % side);
+    float eye = positions[from].y + eyeHeight, target = positions[to].y;
+    float cells = std::max(std::abs(bi - ai), std::abs(bj - aj));
+    int steps = std::max(1, (int)(cells * 4));
+    for (int s = 1; s < steps; ++s) {
+        float t = float(s) / steps;
+        if (heightAt(ai + t * (bi - ai), aj + t * (bj - aj)) > eye + t * (target - eye)) return false;
+    }
+    return true;
+}
+
+// Viewshed: sweep time by thread count and grid size, agreement with exact ray casting
+static void benchViewshed(const BenchMap& map) {
+    const float eyeHeight = 0.01f;
+    Viewshed viewshed(map.positions);
+    int side = viewshed.grid().side;
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> pick(0, side * side - 1);
+    int observers[] = {map.peakIndex, 0, pick(rng), pick(rng)};
+
+    for (int observer : observers) {
+        viewshed.compute(observer, eyeHeight);
+        size_t agree = 0, samples = 4000;
+        for (size_t s = 0; s < samples; ++s) {
+            int target = pick(rng);
+            agree += (viewshed.mask()[target] != 0) == rayVisible(map.positions, side, observer, target, eyeHeight);
+        }
+        std::printf("viewshed from %7d: %.1f%% visible in %.2f ms, %.1f%% of %zu cells agree with ray casting\n",
+                    observer, 100.0 * viewshed.visibleCount() / map.positions.size(), viewshed.lastMs(),
+                    100.0 * agree / samples, samples);
+    }
+
+    // Dragging the observer on a 2049^2 grid
+    std::vector<glm::vec3> positions = terrainPositions(2048, 2022053872u);
+    for (int threads : {1, 2, 4, 8}) {
+        Viewshed big(positions, threads);
+        double total = 0.0, worst = 0.0;
+        const int drags = 10;
+        for (int d = 0; d < drags; ++d) {
+            // Observer moving along the diagonal, as when dragged across the map
+            int at = 2049 / 4 + d * 100;
+            big.compute(at * 2049 + at, eyeHeight);
+            total += big.lastMs();
+            worst = std::max(worst, big.lastMs());
+        }
+        std::printf("  2049x2049, %d threads: %.1f ms mean, %.1f ms worst over %d observers\n", threads,
+                    total / drags, worst, drags);
+    }
+}
+
+// Hydrology: sequential vs tiled depression filling (must agree exactly), drainage on a 4097^2 map
+static void benchHydrology(const BenchMap& map) {
+    HeightGrid grid(map.positions);
+    auto report = [](const char* name, const DrainageNetwork& net) {
+        size_t drained = 0;
+        uint32_t largest = 0;
+        for (size_t v = 0; v < net.downstream.size(); ++v) {
+            if (net.downstream[v] < 0) drained += net.accumulation[v];
+            largest = std::max(largest, net.accumulation[v]);
+        }
+        std::printf("  %-22s fill %7.1f ms, D8 %6.1f ms, accumulation %6.1f ms | largest basin %u, %zu of %zu"
+                    " vertices reach an outlet\n", name, net.fillMs, net.directionMs, net.accumulationMs, largest,
+                    drained, net.downstream.size());
+    };
+    auto differences = [](const std::vector<float>& a, const std::vector<float>& b) {
+        size_t n = 0;
+        for (size_t v = 0; v < a.size(); ++v) n += a[v] != b[v];
+        return n;
+    };
+
+    std::printf("hydrology %dx%d:\n", grid.side, grid.side);
+    DrainageNetwork sequential = analyzeDrainage(grid);
+    report("priority-flood", sequential);
+    size_t raised = 0;
+    for (size_t v = 0; v < grid.size(); ++v) raised += sequential.filled[v] > grid.heights[v];
+    std::printf("  %zu vertices raised by filling\n", raised);
+    for (int tile : {64, 256}) {
+        DrainageNetwork tiled = analyzeDrainage(grid, tile);
+        char name[64];
+        std::snprintf(name, sizeof name, "tiled %d", tile);
+        report(name, tiled);
+        std::printf("    %zu filled heights differ from priority-flood\n", differences(tiled.filled, sequential.filled));
+    }
+
+    // Channel term in path costs: how much of each route runs along drainage channels
+    std::vector<float> wetness = channelStrength(sequential.accumulation, 64);
+    EdgeAttributes attributes(map.graph);
+    attributes.setWetness(wetness);
+    SearchWorkspace ws(map.graph.size());
+    for (float channel : {0.0f, 50.0f, 200.0f}) {
+        CostProfile profile;
+        profile.channel = channel;
+        std::vector<float> costs;
+        attributes.evaluate(profile, costs);
+        double wetRun = 0.0, run = 0.0, slopeCost = 0.0;
+        for (const Query& q : makeQueries(map, 4)) {
+            auto path = findPathProfile(map.graph, attributes, profile, costs, q.start, q.goal, ws);
+            slopeCost += pathCost(map.graph, path);
+            for (size_t i = 0; i + 1 < path.size(); ++i) {
+                float step = horizontalDistance(map.positions[path[i]], map.positions[path[i+1]]);
+                run += step;
+                wetRun += step * std::max(wetness[path[i]], wetness[path[i+1]]);
+            }
+        }
+        std::printf("  channel weight %5.0f: %.1f%% of route length wet, slope cost %.1f\n", channel,
+                    100.0 * wetRun / run, slopeCost);
+    }
+
+    HeightGrid big(terrainPositions(4096, 2022053872u));
+    std::printf("hydrology %dx%d:\n", big.side, big.side);
+    DrainageNetwork bigSequential = analyzeDrainage(big);
+    report("priority-flood", bigSequential);
+    for (int threads : {1, 4, hardwareThreads()}) {
+        DrainageNetwork tiled = analyzeDrainage(big, 512, threads);
+        char name[64];
+        std::snprintf(name, sizeof name, "tiled 512, %d threads", threads);
+        report(name, tiled);
+        size_t areas = 0;
+        for (size_t v = 0; v < big.size(); ++v) areas += tiled.accumulation[v] != bigSequential.accumulation[v];
+        std::printf("    %zu filled heights and %zu areas differ from priority-flood\n",
+                    differences(tiled.filled, bigSequential.filled), areas);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+struct Section {
+    const char* name;
+    void (*run)(const BenchMap&);
+    bool inAll = true;   // run by "all", not only when named
+};
+
+// Contours: segment count against a plain per-cell count, stitching, interval changes and edits on 4097^2
+static void benchContours(const BenchMap& map) {
+    HeightGrid grid(map.positions);
+    ContourMap contours(grid, 0.02f);
+    // Every cell crossing a level gives one segment, a saddle two
+    size_t expected = 0;
+    for (int i = 0; i + 1 < grid.side; ++i) {
+        for (int j = 0; j + 1 < grid.side; ++j) {
+            const float* h = &grid.heights[i * grid.side + j];
+            float c[4] = {h[0], h[grid.side], h[grid.side + 1], h[1]};
+            for (int k = 0; k < 100; ++k) {
+                float L = k * 0.02f;
+                int above = (c[0] >= L) + (c[1] >= L) + (c[2] >= L) + (c[3] >= L);
+                bool saddle = above == 2 && (c[0] >= L) == (c[2] >= L);
+                expected += saddle ? 2 : (above > 0 && above < 4);
+            }
+        }
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    auto lines = contours.polylines();
+    double stitchMs = elapsedMs(t0);
+    size_t closed = 0, points = 0, badEnds = 0;
+    float lo = grid.origin.x, hi = grid.origin.x + (grid.side - 1) * grid.spacing, eps = 1e-4f;
+    auto onEdge = [&](const glm::vec3& p) {
+        return std::fabs(p.x - lo) < eps || std::fabs(p.x - hi) < eps || std::fabs(p.z - grid.origin.y) < eps ||
+               std::fabs(p.z - (grid.origin.y + (grid.side - 1) * grid.spacing)) < eps;
+    };
+    for (const ContourLine& line : lines) {
+        closed += line.closed;
+        points += line.points.size();
+        if (!line.closed) badEnds += !onEdge(line.points.front()) + !onEdge(line.points.back());
+    }
+    std::printf("contours %dx%d, interval 0.02: %zu segments (%zu by per-cell count) in %.2f ms; stitched into "
+                "%zu lines (%zu closed, %zu points, %zu open ends off the map edge) in %.2f ms\n",
+                grid.side, grid.side, contours.segmentCount(), expected, contours.lastMs(), lines.size(), closed,
+                points, badEnds, stitchMs);
+
+    HeightGrid big(terrainPositions(4096, 2022053872u));
+    for (int threads : {1, 4, hardwareThreads()}) {
+        ContourMap map4k(big, 0.05f, 0.0f, 64, threads);
+        std::printf("  %dx%d, %d threads: built in %.1f ms;", big.side, big.side, threads, map4k.lastMs());
+        for (float interval : {0.1f, 0.02f, 0.01f, 0.05f}) {
+            map4k.setInterval(interval);
+            std::printf(" interval %.2f -> %.1f ms (%zu segments);", interval, map4k.lastMs(),
+                        map4k.segmentCount());
+        }
+        std::printf("\n");
+    }
+
+    // A bump raised under one spot: only the tiles around it are redone, and the
+    // result must match contouring the edited map from scratch
+    ContourMap edited(big, 0.05f);
+    HeightGrid reference = big;
+    int ci = big.side / 3, cj = big.side / 2;
+    for (int di = -40; di <= 40; ++di) {
+        for (int dj = -40; dj <= 40; ++dj) {
+            float r2 = float(di * di + dj * dj) / (40.0f * 40.0f);
+            if (r2 >= 1.0f) continue;
+            int v = (ci + di) * big.side + cj + dj;
+            float h = big.heights[v] + 0.05f * (1.0f - r2);
+            edited.setHeight(v, h);
+            reference.heights[v] = h;
+        }
+    }
+    size_t redone = edited.update();
+    double editMs = edited.lastMs();
+    ContourMap fresh(reference, 0.05f);
+    std::printf("  edit: %zu tiles regenerated in %.2f ms, %s a full rebuild\n", redone, editMs,
+                edited.vertexData() == fresh.vertexData() ? "identical to" : "DIFFERENT from");
+}
+
+// Horizon bake: sampled against marching every sight line, then timings up to 4097^2
+static void benchHorizons(const BenchMap& map) {
+    HeightGrid grid(map.positions);
+    HorizonMap horizons(grid);
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> pick(0, (int)grid.size() - 1);
+    const float halfPi = 1.57079632679f;
+    double worst = 0.0;
+    size_t samples = 2000, shadowed = 0, skySum = 0;
+    for (size_t n = 0; n < samples; ++n) {
+        int v = pick(rng);
+        int i = v / grid.side, j = v % grid.side;
+        for (int d = 0; d < HorizonMap::DIRECTIONS; ++d) {
+            glm::ivec2 step = HorizonMap::gridStep(d);
+            float stepLength = grid.spacing * glm::length(glm::vec2(step));
+            float best = 0.0f;
+            for (int m = 1;; ++m) {
+                int si = i + m * step.x, sj = j + m * step.y;
+                if (si < 0 || si >= grid.side || sj < 0 || sj >= grid.side) break;
+                best = std::max(best, (grid.heights[si * grid.side + sj] - grid.heights[v]) / (m * stepLength));
+            }
+            // In units of the stored byte; rounding allows half a step
+            double exact = std::atan(best) / halfPi * 255.0;
+            worst = std::max(worst, std::fabs(exact - horizons.angles()[(size_t)v * HorizonMap::DIRECTIONS + d]));
+        }
+    }
+    // Low sun from the south-west
+    glm::vec3 toSun = glm::normalize(glm::vec3(std::cos(0.6f), std::tan(0.35f), std::sin(0.6f)));
+    float weights[HorizonMap::DIRECTIONS];
+    HorizonMap::sunWeights(toSun, weights);
+    float elevation = std::asin(toSun.y);
+    for (size_t v = 0; v < grid.size(); ++v) {
+        float h = 0.0f;
+        for (int d = 0; d < HorizonMap::DIRECTIONS; ++d) h += weights[d] * horizons.horizonAngle((int)v, d);
+        shadowed += h > elevation;
+        skySum += horizons.skyView()[v];
+    }
+    std::printf("horizons %dx%d: baked in %.1f ms; worst of %zu x %d sight lines %.3f steps from exact; "
+                "%.1f%% in shadow at 20 deg sun, mean open sky %.1f%%\n", grid.side, grid.side, horizons.lastMs(),
+                samples, HorizonMap::DIRECTIONS, worst, 100.0 * shadowed / grid.size(),
+                100.0 * skySum / (255.0 * grid.size()));
+
+    for (int n : {1024, 2048, 4096}) {
+        HeightGrid big(terrainPositions(n, 2022053872u));
+        for (int threads : {1, hardwareThreads()}) {
+            HorizonMap baked(big, threads);
+            std::printf("  %dx%d, %d threads: %.1f ms\n", big.side, big.side, threads, baked.lastMs());
+        }
+    }
+}
+
+static const Section sections[] = {
+    {"openset", benchOpenSets},
+    {"bidir", benchBidirectional},
+    {"hpa", benchHierarchical},
+    {"ch", benchContraction, false},
+    {"alt", benchLandmarks},
+    {"batch", benchBatch},
+    {"lpa", benchIncremental},
+    {"flow", benchFlowField},
+    {"delta", benchDeltaStepping},
+    {"ara", benchAnytime},
+    {"async", benchAsync},
+    {"policy", benchCostPolicies},
+    {"profile", benchProfiles},
+    {"alt-routes", benchAlternatives},
+    {"peaks", benchPeaks},
+    {"viewshed", benchViewshed},
+    {"hydro", benchHydrology},
+    {"contours", benchContours},
+    {"horizons", benchHorizons},
+};
+
+int main(int argc, char** argv) {
+    const char* which = argc > 1 ? argv[1] : "all";
+    int N = argc > 2 ? std::atoi(argv[2]) : 512;
+    uint32_t seed = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 2022053872u;
+
+    auto t0 = std::chrono::steady_clock::now();
+    BenchMap map = makeMap(N, seed);
+    std::printf("map %dx%d: %zu nodes, built in %.1f ms\n", N + 1, N + 1, map.graph.size(), elapsedMs(t0));
+
+    bool ran = false;
+    for (const Section& s : sections) {
+        if ((std::strcmp(which, "all") == 0 && s.inAll) || std::strcmp(which, s.name) == 0) {
+            s.run(map);
+            ran = true;
+        }
+    }
+    if (!ran) {
+        std::fprintf(stderr, "unknown section '%s'\n", which);
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "bidirectional.h"
+#include <algorithm>
+#include <limits>
+
+BidirectionalPathfinder::BidirectionalPathfinder(const std::vector<Node>& g, int s, int goal, float hScale)
+    : graph(g), startIndex(s), goalIndex(goal), hScale(hScale),
+      fwd(&ownForward), bwd(&ownBackward)
+{
+    start();
+}
+
+BidirectionalPathfinder::BidirectionalPathfinder(const std::vector<Node>& g, int s, int goal, float hScale,
+                                                 SearchWorkspace& forwardWs, SearchWorkspace& backwardWs)
+    : graph(g), startIndex(s), goalIndex(goal), hScale(hScale),
+      fwd(&forwardWs), bwd(&backwardWs)
+{
+    start();
+}
+
+void BidirectionalPathfinder::start() {
+    mu = std::numeric_limits<float>::infinity();
+    fwd->beginQuery(graph.size());
+    bwd->beginQuery(graph.size());
+    fwd->openSet.reset(graph.size());
+    bwd->openSet.reset(graph.size());
+
+    fwd->set(startIndex, 0.0f, -1);
+    fwd->openSet.push(startIndex, potential(startIndex));
+    bwd->set(goalIndex, 0.0f, -1);
+    bwd->openSet.push(goalIndex, -potential(goalIndex));
+
+    if (startIndex == goalIndex) {
+        mu = 0.0f;
+        meetNode = startIndex;
+    }
+}
+
+float BidirectionalPathfinder::potential(int v) const {
+    const glm::vec3& p = graph[v].position;
+    float toGoal = glm::length(graph[goalIndex].position - p);
+    float fromStart = glm::length(p - graph[startIndex].position);
+    return 0.5f * hScale * (toGoal - fromStart);
+}
+
+bool BidirectionalPathfinder::finished() const {
+    if (fwd->openSet.empty() || bwd->openSet.empty()) return true;
+    // Any path not yet seen costs at least the two smallest keys combined
+    return fwd->openSet.minKey() + bwd->openSet.minKey() >= mu;
+}
+
+bool BidirectionalPathfinder::step(SearchState& state) {
+    if (done) return false;
+
+    state.frontier.clear();
+    if (finished()) {
+        done = true;
+        state.path = joinedPath();
+        return false;
+    }
+
+    // Expand the side with the smaller open set
+    bool forward = fwd->openSet.size() <= bwd->openSet.size();
+    SearchWorkspace& self = forward ? *fwd : *bwd;
+    SearchWorkspace& other = forward ? *bwd : *fwd;
+    float sign = forward ? 1.0f : -1.0f;
+
+    int u = self.openSet.pop();
+    self.close(u);
+    ++expanded;
+    state.visited.push_back(u);
+
+    float du = self.dist(u);
+    for (const Edge& e : graph[u].neighbors) {
+        float tentative_g = du + e.cost;
+        if (tentative_g < self.dist(e.to) && !self.isClosed(e.to)) {
+            self.set(e.to, tentative_g, u);
+            self.openSet.push(e.to, tentative_g + sign * potential(e.to));
+            state.frontier.push_back(e.to);
+        }
+        // Candidate meeting point
+        float through = self.dist(e.to) + other.dist(e.to);
+        if (through < mu) {
+            mu = through;
+            meetNode = e.to;
+        }
+    }
+    return true;
+}
+
+std::vector<int> BidirectionalPathfinder::joinedPath() const {
+    if (meetNode < 0) return {};
+    std::vector<int> path = fwd->pathTo(meetNode);
+    for (int v = bwd->prev(meetNode); v != -1; v = bwd->prev(v)) {
+        path.push_back(v);
+    }
+    return path;
+}
+
+std::vector<int> BidirectionalPathfinder::currentBestPath(int target) const {
+    if (meetNode >= 0) return joinedPath();
+
+    // No meeting yet: show the branch of whichever tree reached target
+    if (fwd->isClosed(target) || !bwd->isClosed(target)) return fwd->pathTo(target);
+    std::vector<int> path;
+    for (int v = target; v != -1; v = bwd->prev(v)) path.push_back(v);
+    return path;
+}
+
+int BidirectionalPathfinder::parentOf(int v) const {
+    return fwd->isClosed(v) || !bwd->isClosed(v) ? fwd->prev(v) : bwd->prev(v);
+}
+
+std::vector<int> BidirectionalPathfinder::run() {
+    SearchState state;
+    while (step(state)) {
+        state.visited.clear(); // not needed when nobody is watching
+    }
+    return state.path;
+}
+
+std::vector<int> findPathBidirectional(const std::vector<Node>& graph, int startIndex, int goalIndex,
+                                       float hScale) {
+    BidirectionalPathfinder search(graph, startIndex, goalIndex, hScale);
+    return search.run();
+}
\ No newline at end of file
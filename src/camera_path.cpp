@@ -0,0 +1,58 @@
+#include "camera_path.h"
+#include <algorithm>
+#include <cmath>
+
+void CameraPath::add(float time, const glm::vec3& position, const glm::vec3& target) {
+    keys.push_back({time, position, target});
+}
+
+static glm::vec3 catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3,
+                            float t) {
+    float t2 = t * t, t3 = t2 * t;
+    return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                   (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+Camera CameraPath::at(float t) const {
+    Camera camera;
+    if (keys.empty()) return camera;
+
+    glm::vec3 position = keys[0].position, target = keys[0].target;
+    if (keys.size() > 1) {
+        t = std::clamp(t, keys.front().time, keys.back().time);
+        size_t k = 0;
+        while (k + 2 < keys.size() && keys[k + 1].time <= t) ++k;
+        const Keyframe& a = keys[k];
+        const Keyframe& b = keys[k + 1];
+        float u = b.time > a.time ? (t - a.time) / (b.time - a.time) : 0.0f;
+        // End tangents: wrap round a closed loop, otherwise repeat the end point
+        bool closed = keys.front().position == keys.back().position;
+        const glm::vec3& before = k > 0 ? keys[k - 1].position
+                                : closed ? keys[keys.size() - 2].position : a.position;
+        const glm::vec3& after = k + 2 < keys.size() ? keys[k + 2].position
+                               : closed ? keys[1].position : b.position;
+        position = catmullRom(before, a.position, b.position, after, u);
+        target = glm::mix(a.target, b.target, u);
+    }
+
+    camera.position = position;
+    camera.front = glm::normalize(target - position);
+    camera.yaw = glm::degrees(std::atan2(camera.front.z, camera.front.x));
+    camera.pitch = glm::degrees(std::asin(glm::clamp(camera.front.y, -1.0f, 1.0f)));
+    return camera;
+}
+
+CameraPath CameraPath::orbit(const glm::vec3& center, float radius, float height, float seconds, int keyframes) {
+    const float TWO_PI = 6.28318530718f;
+    CameraPath path;
+    keyframes = std::max(keyframes, 4);
+    for (int k = 0; k <= keyframes; ++k) {
+        int n = k % keyframes;   // the last keyframe is the first again
+        float a = TWO_PI * n / keyframes;
+        float s = std::sin(1.5f * a);
+        float r = radius * (1.0f - 0.5f * s * s);
+        float y = height * (1.0f + 0.4f * std::sin(2.0f * a));
+        path.add(seconds * k / keyframes, center + glm::vec3(r * std::cos(a), y, r * std::sin(a)), center);
+    }
+    return path;
+}
@@ -0,0 +1,255 @@
+#include "contours.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "parallel.h"
+
+static const int STRIP = 16;         // cells per row strip with a stored height range
+static const float LIFT = 0.01f;     // drawn just above the ground, as paths are
+
+ContourMap::ContourMap(const HeightGrid& grid, float interval, float base, int tileSize, int threads)
+    : terrain(grid), step(std::max(interval, 1e-6f)), base(base), threads(threads)
+{
+    // Tiles hold whole strips
+    this->tileSize = std::max(STRIP, (tileSize + STRIP - 1) / STRIP * STRIP);
+    int cells = std::max(terrain.side - 1, 0);
+    tilesPerSide = (cells + this->tileSize - 1) / this->tileSize;
+    stripsPerRow = (cells + STRIP - 1) / STRIP;
+    stripLo.assign((size_t)cells * stripsPerRow, 0.0f);
+    stripHi.assign(stripLo.size(), 0.0f);
+    for (int n = 0; n < terrain.side; ++n) {
+        xs.push_back(terrain.origin.x + n * terrain.spacing);
+        zs.push_back(terrain.origin.y + n * terrain.spacing);
+    }
+
+    for (int ti = 0; ti < tilesPerSide; ++ti) {
+        for (int tj = 0; tj < tilesPerSide; ++tj) {
+            Tile tile;
+            tile.i0 = ti * this->tileSize;
+            tile.j0 = tj * this->tileSize;
+            tile.i1 = std::min(tile.i0 + this->tileSize, cells);
+            tile.j1 = std::min(tile.j0 + this->tileSize, cells);
+            tiles.push_back(std::move(tile));
+        }
+    }
+    update();
+}
+
+int ContourMap::firstLevelAbove(float h) const {
+    int k = static_cast<int>(std::floor((h - base) / step));
+    // The division can be off by one either way; settle it with the same expression the cells use
+    while (level(k) <= h) ++k;
+    while (level(k - 1) > h) --k;
+    return k;
+}
+
+void ContourMap::setInterval(float interval, float newBase, int newIndexEvery) {
+    step = std::max(interval, 1e-6f);
+    base = newBase;
+    indexEvery = std::max(newIndexEvery, 1);
+    for (Tile& tile : tiles) tile.dirty = true;
+    update();
+}
+
+void ContourMap::setHeight(int vertex, float height) {
+    terrain.heights[vertex] = height;
+    int side = terrain.side, cells = side - 1;
+    int i = vertex / side, j = vertex % side;
+    // The (up to) four cells that have this vertex as a corner
+    for (int ci = std::max(i - 1, 0); ci <= std::min(i, cells - 1); ++ci) {
+        for (int cj = std::max(j - 1, 0); cj <= std::min(j, cells - 1); ++cj) {
+            Tile& tile = tiles[(ci / tileSize) * tilesPerSide + cj / tileSize];
+            tile.dirty = true;
+            tile.rangesStale = true;
+        }
+    }
+}
+
+size_t ContourMap::update() {
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<Tile*> dirty;
+    for (Tile& tile : tiles) {
+        if (tile.dirty) dirty.push_back(&tile);
+    }
+    parallelFor((int)dirty.size(), [&](int t, int) {
+        Tile& tile = *dirty[t];
+        if (tile.rangesStale) refreshRanges(tile);
+        extractTile(tile);
+        tile.dirty = false;
+    }, threads);
+    if (!dirty.empty()) joinedStale = true;
+    extractTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return dirty.size();
+}
+
+void ContourMap::refreshRanges(Tile& tile) {
+    const int side = terrain.side;
+    const float* h = terrain.heights.data();
+    for (int i = tile.i0; i < tile.i1; ++i) {
+        for (int j0 = tile.j0; j0 < tile.j1; j0 += STRIP) {
+            int j1 = std::min(j0 + STRIP, tile.j1);
+            float lo = h[i * side + j0], hi = lo;
+            for (int r = i; r <= i + 1; ++r) {
+                for (int j = j0; j <= j1; ++j) {
+                    lo = std::min(lo, h[r * side + j]);
+                    hi = std::max(hi, h[r * side + j]);
+                }
+            }
+            size_t s = (size_t)i * stripsPerRow + j0 / STRIP;
+            stripLo[s] = lo;
+            stripHi[s] = hi;
+        }
+    }
+    tile.rangesStale = false;
+}
+
+// Cell (i, j) has corners v00 = (i, j), v10 = (i+1, j), v11 = (i+1, j+1), v01 = (i, j+1).
+// Edge e0 = v00-v10, e1 = v10-v11, e2 = v01-v11, e3 = v00-v01; a crossing is keyed by
+// the grid edge (2 * lower vertex, +1 when it runs along j), so neighbouring cells and
+// tiles compute the same point for it and stitching can match the keys.
+void ContourMap::extractTile(Tile& tile) {
+    const int side = terrain.side;
+    const float* h = terrain.heights.data();
+    const float* x = xs.data();
+    const float* z = zs.data();
+    tile.data.clear();
+    tile.ends.clear();
+
+    for (int i = tile.i0; i < tile.i1; ++i) {
+        for (int j0 = tile.j0; j0 < tile.j1; j0 += STRIP) {
+            // Levels within the strip's range; a strip without one is skipped unread
+            size_t s = (size_t)i * stripsPerRow + j0 / STRIP;
+            int kFirst = firstLevelAbove(stripLo[s]), kEnd = kFirst;
+            while (level(kEnd) <= stripHi[s]) ++kEnd;
+            if (kEnd == kFirst) continue;
+
+            int j1 = std::min(j0 + STRIP, tile.j1);
+            for (int j = j0; j < j1; ++j) {
+                const int v00 = i * side + j, v10 = v00 + side, v11 = v10 + 1, v01 = v00 + 1;
+                const float h00 = h[v00], h10 = h[v10], h11 = h[v11], h01 = h[v01];
+                float lo = std::min(std::min(h00, h10), std::min(h11, h01));
+                float hi = std::max(std::max(h00, h10), std::max(h11, h01));
+                const int edgeA[4] = {v00, v10, v01, v00};
+                const int edgeB[4] = {v10, v11, v11, v01};
+                const uint32_t edgeId[4] = {2u * v00, 2u * v10 + 1, 2u * v01, 2u * v00 + 1};
+                const int edgeI[4] = {i, i + 1, i, i};     // grid coordinates of each edge's first vertex
+                const int edgeJ[4] = {j, j, j + 1, j};
+
+                for (int k = kFirst; k < kEnd; ++k) {
+                    const float L = level(k);
+                    if (L <= lo || L > hi) continue;
+                    int cell = (h00 >= L) | (h10 >= L) << 1 | (h11 >= L) << 2 | (h01 >= L) << 3;
+                    int pairs[2][2];
+                    int count = 1;
+                    if (cell == 5 || cell == 10) {
+                        bool centre = (h00 + h10 + h11 + h01) * 0.25f >= L;
+                        bool cutV00 = (cell == 5) != centre;   // lines cut off v00 and v11, else v10 and v01
+                        pairs[0][0] = 0; pairs[0][1] = cutV00 ? 3 : 1;
+                        pairs[1][0] = 2; pairs[1][1] = cutV00 ? 1 : 3;
+                        count = 2;
+                    } else {
+                        int crossed[2], n = 0;
+                        for (int e = 0; e < 4; ++e) {
+                            if ((h[edgeA[e]] >= L) != (h[edgeB[e]] >= L)) crossed[n++] = e;
+                        }
+                        pairs[0][0] = crossed[0];
+                        pairs[0][1] = crossed[1];
+                    }
+
+                    int phase = ((k % indexEvery) + indexEvery) % indexEvery;
+                    glm::vec3 c = phase == 0 ? glm::vec3(0.25f, 0.15f, 0.08f) : glm::vec3(0.5f, 0.38f, 0.25f);
+                    for (int p = 0; p < count; ++p) {
+                        for (int end = 0; end < 2; ++end) {
+                            int e = pairs[p][end];
+                            int a = edgeA[e], b = edgeB[e];
+                            float t = (L - h[a]) / (h[b] - h[a]);
+                            int ei = edgeI[e], ej = edgeJ[e];
+                            // e0 and e2 run along i, e1 and e3 along j
+                            float px = (e & 1) ? x[ei] : x[ei] + t * (x[ei + 1] - x[ei]);
+                            float pz = (e & 1) ? z[ej] + t * (z[ej + 1] - z[ej]) : z[ej];
+                            const float vertex[6] = {px, L + LIFT, pz, c.r, c.g, c.b};
+                            tile.data.insert(tile.data.end(), vertex, vertex + 6);
+                            tile.ends.push_back((uint64_t)(uint32_t)k << 32 | edgeId[e]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+const std::vector<float>& ContourMap::vertexData() {
+    if (joinedStale) {
+        size_t total = 0;
+        for (const Tile& tile : tiles) total += tile.data.size();
+        joined.clear();
+        joined.reserve(total);
+        for (const Tile& tile : tiles) joined.insert(joined.end(), tile.data.begin(), tile.data.end());
+        joinedStale = false;
+    }
+    return joined;
+}
+
+size_t ContourMap::segmentCount() const {
+    size_t total = 0;
+    for (const Tile& tile : tiles) total += tile.ends.size() / 2;
+    return total;
+}
+
+// Each crossing lies on exactly two cells unless it is on the map edge, so
+// sorting segment ends by key pairs them up; chains are then walked from
+// the unpaired ends first, and whatever is left over is a loop.
+std::vector<ContourLine> ContourMap::polylines() const {
+    std::vector<glm::vec3> points;
+    std::vector<uint64_t> keys;
+    for (const Tile& tile : tiles) {
+        for (size_t p = 0; p < tile.ends.size(); ++p) {
+            points.emplace_back(tile.data[6*p], tile.data[6*p+1] - LIFT, tile.data[6*p+2]);
+            keys.push_back(tile.ends[p]);
+        }
+    }
+    std::vector<uint32_t> order(keys.size());
+    for (uint32_t p = 0; p < order.size(); ++p) order[p] = p;
+    parallelSort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; }, threads);
+
+    std::vector<int> partner(keys.size(), -1);
+    for (size_t n = 0; n + 1 < order.size(); ++n) {
+        if (keys[order[n]] == keys[order[n + 1]]) {
+            partner[order[n]] = order[n + 1];
+            partner[order[n + 1]] = order[n];
+            ++n;
+        }
+    }
+
+    std::vector<ContourLine> lines;
+    std::vector<char> used(keys.size() / 2, 0);
+    auto trace = [&](int endpoint) {
+        ContourLine line;
+        line.level = level((int32_t)(keys[endpoint] >> 32));
+        line.closed = false;
+        line.points.push_back(points[endpoint]);
+        for (int at = endpoint;;) {
+            used[at >> 1] = 1;
+            int exit = at ^ 1;                 // the segment's other end
+            line.points.push_back(points[exit]);
+            int next = partner[exit];
+            if (next < 0) break;               // reached the map edge
+            if (used[next >> 1]) {             // back at the start
+                line.closed = true;
+                line.points.pop_back();        // same crossing as the first point
+                break;
+            }
+            at = next;
+        }
+        lines.push_back(std::move(line));
+    };
+    for (size_t p = 0; p < keys.size(); ++p) {
+        if (partner[p] < 0 && !used[p >> 1]) trace((int)p);
+    }
+    for (size_t p = 0; p < keys.size(); p += 2) {
+        if (!used[p >> 1]) trace((int)p);
+    }
+    std::stable_sort(lines.begin(), lines.end(),
+                     [](const ContourLine& a, const ContourLine& b) { return a.level < b.level; });
+    return lines;
+}
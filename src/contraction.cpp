@@ -0,0 +1,337 @@
+#include "contraction.h"
+#include "parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+// Witness searches give up after settling this many nodes, or stop expanding
+// past this many arcs from the source, and the shortcut is added. Contracting a
+// node uses the wide limits; estimating its priority uses the narrow ones, which
+// overcount shortcuts a little but are a fraction of the work.
+static const int WITNESS_SETTLE_LIMIT = 400;
+static const int WITNESS_HOP_LIMIT = 6;
+static const int PRIORITY_SETTLE_LIMIT = 60;
+static const int PRIORITY_HOP_LIMIT = 3;
+
+namespace {
+
+struct Shortcut {
+    int from, to;
+    float cost;
+    int middle;
+};
+
+// Per-thread scratch for witness searches
+struct WitnessScratch {
+    SearchWorkspace ws;
+    std::vector<int> targetOf;   // node -> search id it is a target for
+    std::vector<int> hops;       // arcs from the source; valid where ws.dist is finite
+    int searchId = 0;
+};
+
+struct Overlay {
+    struct Arc {
+        int to;
+        float cost;
+        int middle;
+    };
+    std::vector<std::vector<Arc>> adj;    // remaining (uncontracted) graph
+    std::vector<char> removed;            // contracted, or being contracted this round
+    std::vector<int> contractedNeighbors;
+    std::vector<int> depth;               // 1 + depth of the deepest contracted neighbour
+    std::vector<float> priority;
+
+    void addOrImprove(int from, int to, float cost, int middle) {
+        for (Arc& a : adj[from]) {
+            if (a.to == to) {
+                if (cost < a.cost) { a.cost = cost; a.middle = middle; }
+                return;
+            }
+        }
+        adj[from].push_back({to, cost, middle});
+    }
+
+    // Dijkstra from nbrs[first] in the remaining graph without v, stopping once
+    // nbrs[first+1..] are all settled or the cost/settle limits are hit
+    void witnessSearch(int v, size_t first, float maxCost, int settleLimit, int hopLimit,
+                       WitnessScratch& scratch) const {
+        const auto& nbrs = adj[v];
+        SearchWorkspace& ws = scratch.ws;
+        if (scratch.targetOf.size() < adj.size()) {
+            scratch.targetOf.assign(adj.size(), 0);
+            scratch.hops.assign(adj.size(), 0);
+        }
+        int id = ++scratch.searchId;
+        for (size_t j = first + 1; j < nbrs.size(); ++j) scratch.targetOf[nbrs[j].to] = id;
+
+        int source = nbrs[first].to;
+        ws.beginQuery(adj.size());
+        ws.openSet.reset(adj.size());
+        ws.set(source, 0.0f, -1);
+        scratch.hops[source] = 0;
+        ws.openSet.push(source, 0.0f);
+
+        size_t targetsLeft = nbrs.size() - first - 1;
+        int settledCount = 0;
+        while (!ws.openSet.empty()) {
+            int u = ws.openSet.pop();
+            ws.close(u);
+            float du = ws.dist(u);
+            if (du > maxCost || ++settledCount > settleLimit) break;
+            if (scratch.targetOf[u] == id && --targetsLeft == 0) break;
+            if (scratch.hops[u] >= hopLimit) continue;
+            for (const Arc& a : adj[u]) {
+                if (removed[a.to] || a.to == v) continue;
+                float tentative_g = du + a.cost;
+                if (tentative_g < ws.dist(a.to) && !ws.isClosed(a.to)) {
+                    ws.set(a.to, tentative_g, u);
+                    scratch.hops[a.to] = scratch.hops[u] + 1;
+                    ws.openSet.push(a.to, tentative_g);
+                }
+            }
+        }
+    }
+
+    // Shortcuts needed to remove v while keeping all distances among its neighbours.
+    // Only reads the overlay, so many nodes can be evaluated at once.
+    void shortcutsFor(int v, int settleLimit, int hopLimit, WitnessScratch& scratch,
+                      std::vector<Shortcut>& out) const {
+        out.clear();
+        const auto& nbrs = adj[v];
+        for (size_t i = 0; i + 1 < nbrs.size(); ++i) {
+            float farthest = 0.0f;
+            for (size_t j = i + 1; j < nbrs.size(); ++j) farthest = std::max(farthest, nbrs[j].cost);
+
+            witnessSearch(v, i, nbrs[i].cost + farthest, settleLimit, hopLimit, scratch);
+            for (size_t j = i + 1; j < nbrs.size(); ++j) {
+                float via = nbrs[i].cost + nbrs[j].cost;
+                if (scratch.ws.dist(nbrs[j].to) > via) out.push_back({nbrs[i].to, nbrs[j].to, via, v});
+            }
+        }
+    }
+
+    // Edge difference plus uniformity and depth terms; the last two spread
+    // contraction evenly over the grid instead of letting it eat in from one front
+    float score(int v, size_t shortcutCount) const {
+        float edgeDifference = static_cast<float>(shortcutCount) - static_cast<float>(adj[v].size());
+        return 2.0f * edgeDifference + contractedNeighbors[v] + depth[v];
+    }
+
+    float computePriority(int v, WitnessScratch& scratch, std::vector<Shortcut>& shortcuts) const {
+        shortcutsFor(v, PRIORITY_SETTLE_LIMIT, PRIORITY_HOP_LIMIT, scratch, shortcuts);
+        return score(v, shortcuts.size());
+    }
+
+    // v goes in this round if no remaining neighbour ranks before it
+    // (priority, then index), so the chosen nodes are pairwise non-adjacent
+    bool isLocalMinimum(int v) const {
+        for (const Arc& a : adj[v]) {
+            float pv = priority[v], pn = priority[a.to];
+            if (pn < pv || (pn == pv && a.to < v)) return false;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+ContractionHierarchy::ContractionHierarchy(const std::vector<Node>& g, int threads)
+    : graph(g)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    contract(threads > 0 ? threads : hardwareThreads());
+    report.preprocessMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void ContractionHierarchy::contract(int threads) {
+    const int V = static_cast<int>(graph.size());
+    Overlay overlay;
+    overlay.adj.resize(V);
+    overlay.removed.assign(V, 0);
+    overlay.contractedNeighbors.assign(V, 0);
+    overlay.depth.assign(V, 0);
+    overlay.priority.assign(V, 0.0f);
+
+    // buildGraph emits shared triangle edges twice; keep one copy of each
+    for (int u = 0; u < V; ++u) {
+        for (const Edge& e : graph[u].neighbors) {
+            if (e.to != u) overlay.addOrImprove(u, e.to, e.cost, -1);
+        }
+        report.originalEdges += overlay.adj[u].size();
+    }
+    report.originalEdges /= 2;
+
+    std::vector<WitnessScratch> workspaces(threads);
+    std::vector<std::vector<Shortcut>> scratch(threads);
+    parallelFor(V, [&](int v, int w) {
+        overlay.priority[v] = overlay.computePriority(v, workspaces[w], scratch[w]);
+    }, threads, 256);
+
+    rank.assign(V, -1);
+    up.assign(V, {});
+
+    // Contract in rounds. Each round takes every remaining node that is a local
+    // priority minimum; these form an independent set, so their witness searches
+    // run in parallel. Nodes of the round are marked removed first, so no
+    // witness path runs through a node that is disappearing alongside it.
+    // Priorities are refreshed lazily: a contraction only bumps its neighbours'
+    // uniformity term and marks them stale, and a stale node is re-simulated
+    // when it next comes up as a candidate, then has to still be a minimum.
+    std::vector<int> remaining(V), batch, refresh, touched;
+    for (int v = 0; v < V; ++v) remaining[v] = v;
+    std::vector<std::vector<Shortcut>> batchShortcuts;
+    std::vector<int> touchedStamp(V, -1);
+    std::vector<char> stale(V, 0);
+    int nextRank = 0;
+
+    for (int round = 0; !remaining.empty(); ++round) {
+        batch.clear();
+        refresh.clear();
+        for (int v : remaining) {
+            if (!overlay.isLocalMinimum(v)) continue;
+            batch.push_back(v);
+            if (stale[v]) refresh.push_back(v);
+        }
+        if (!refresh.empty()) {
+            parallelFor(static_cast<int>(refresh.size()), [&](int i, int w) {
+                int n = refresh[i];
+                overlay.priority[n] = overlay.computePriority(n, workspaces[w], scratch[w]);
+                stale[n] = 0;
+            }, threads, 16);
+            batch.erase(std::remove_if(batch.begin(), batch.end(),
+                                       [&](int v) { return !overlay.isLocalMinimum(v); }), batch.end());
+        }
+        for (int v : batch) overlay.removed[v] = 1;
+
+        batchShortcuts.resize(batch.size());
+        parallelFor(static_cast<int>(batch.size()), [&](int i, int w) {
+            overlay.shortcutsFor(batch[i], WITNESS_SETTLE_LIMIT, WITNESS_HOP_LIMIT, workspaces[w], batchShortcuts[i]);
+        }, threads, 16);
+
+        touched.clear();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            int v = batch[i];
+            rank[v] = nextRank++;
+            for (const auto& a : overlay.adj[v]) {
+                up[v].push_back({a.to, a.cost, a.middle}); // every remaining neighbour ranks higher
+                auto& back = overlay.adj[a.to];
+                back.erase(std::remove_if(back.begin(), back.end(),
+                                          [v](const Overlay::Arc& b) { return b.to == v; }), back.end());
+                overlay.contractedNeighbors[a.to]++;
+                overlay.depth[a.to] = std::max(overlay.depth[a.to], overlay.depth[v] + 1);
+                if (touchedStamp[a.to] != round) {
+                    touchedStamp[a.to] = round;
+                    touched.push_back(a.to);
+                }
+            }
+            for (const Shortcut& s : batchShortcuts[i]) {
+                overlay.addOrImprove(s.from, s.to, s.cost, s.middle);
+                overlay.addOrImprove(s.to, s.from, s.cost, s.middle);
+            }
+            report.shortcuts += batchShortcuts[i].size();
+            overlay.adj[v].clear();
+            overlay.adj[v].shrink_to_fit();
+        }
+
+        for (int n : touched) {
+            overlay.priority[n] += 1.0f;
+            stale[n] = 1;
+        }
+
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                       [&](int v) { return overlay.removed[v] != 0; }), remaining.end());
+        report.rounds++;
+    }
+
+    for (const auto& edges : up) report.upwardEdges += edges.size();
+}
+
+std::vector<int> ContractionHierarchy::findPath(int start, int goal, float* cost) {
+    const size_t V = graph.size();
+    forward.beginQuery(V);
+    backward.beginQuery(V);
+    forward.openSet.reset(V);
+    backward.openSet.reset(V);
+    settled = 0;
+
+    float mu = start == goal ? 0.0f : INF;
+    int meet = start == goal ? start : -1;
+
+    forward.set(start, 0.0f, -1);
+    forward.openSet.push(start, 0.0f);
+    backward.set(goal, 0.0f, -1);
+    backward.openSet.push(goal, 0.0f);
+
+    while (true) {
+        // A side is finished once nothing it holds can improve the best meeting
+        bool forwardLive = !forward.openSet.empty() && forward.openSet.minKey() < mu;
+        bool backwardLive = !backward.openSet.empty() && backward.openSet.minKey() < mu;
+        if (!forwardLive && !backwardLive) break;
+
+        bool useForward = forwardLive &&
+                          (!backwardLive || forward.openSet.minKey() <= backward.openSet.minKey());
+        SearchWorkspace& self = useForward ? forward : backward;
+        SearchWorkspace& other = useForward ? backward : forward;
+
+        int u = self.openSet.pop();
+        self.close(u);
+        ++settled;
+
+        float du = self.dist(u);
+        float through = du + other.dist(u);
+        if (through < mu) { mu = through; meet = u; }
+
+        // Stall on demand: the graph is undirected, so the upward edges of u are
+        // also the edges into u from higher nodes. If one of those reaches u
+        // more cheaply, du is not a shortest distance and u need not be expanded.
+        bool stalled = false;
+        for (const ChEdge& e : up[u]) {
+            if (self.dist(e.to) + e.cost < du) { stalled = true; break; }
+        }
+        if (stalled) continue;
+
+        for (const ChEdge& e : up[u]) {
+            float tentative_g = du + e.cost;
+            if (tentative_g < self.dist(e.to)) {
+                self.set(e.to, tentative_g, u);
+                self.openSet.push(e.to, tentative_g);
+                float via = tentative_g + other.dist(e.to);
+                if (via < mu) { mu = via; meet = e.to; }
+            }
+        }
+    }
+
+    if (cost) *cost = mu;
+    if (meet < 0) return {};
+
+    // Upward chain start..meet, then meet..goal, each hop unpacked to original edges
+    std::vector<int> hops = forward.pathTo(meet);
+    for (int v = backward.prev(meet); v != -1; v = backward.prev(v)) hops.push_back(v);
+
+    std::vector<int> path = {hops[0]};
+    for (size_t i = 0; i + 1 < hops.size(); ++i) {
+        if (!unpack(hops[i], hops[i + 1], path)) {
+            // A hop with no matching upward edge means the hierarchy is broken;
+            // report that rather than hand back a disconnected path
+            if (cost) *cost = INF;
+            return {};
+        }
+    }
+    return path;
+}
+
+bool ContractionHierarchy::unpack(int a, int b, std::vector<int>& out) const {
+    int low = rank[a] < rank[b] ? a : b;
+    int high = low == a ? b : a;
+    for (const ChEdge& e : up[low]) {
+        if (e.to != high) continue;
+        if (e.middle < 0) {
+            out.push_back(b);
+            return true;
+        }
+        return unpack(a, e.middle, out) && unpack(e.middle, b, out);
+    }
+    return false;
+}
@@ -0,0 +1,202 @@
+#include "delta_stepping.h"
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+namespace {
+
+// Reusable barrier for a fixed group of threads (C++17 has no std::barrier)
+class SpinBarrier {
+public:
+    explicit SpinBarrier(int count) : count(count) {}
+
+    void wait() {
+        unsigned gen = generation.load(std::memory_order_acquire);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+            waiting.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        while (generation.load(std::memory_order_acquire) == gen) std::this_thread::yield();
+    }
+
+private:
+    const int count;
+    std::atomic<int> waiting{0};
+    std::atomic<unsigned> generation{0};
+};
+
+struct Request {
+    int node;
+    float dist;
+};
+
+struct Worker {
+    std::vector<std::vector<int>> buckets;      // absolute bucket index -> owned nodes
+    std::vector<std::vector<Request>> outbox;   // owner -> requests for its nodes
+    std::vector<int> frontier;
+    std::vector<int> settled;                   // nodes removed from the current bucket
+    size_t relaxations = 0;
+};
+
+} // namespace
+
+DeltaStepping::DeltaStepping(const std::vector<Node>& g, float delta, int threads)
+    : bucketWidth(delta > 0.0f ? delta : suggestDelta(g)),
+      threads(threads > 0 ? threads : hardwareThreads())
+{
+    // buildGraph emits shared triangle edges twice; keep the cheapest copy
+    const size_t V = g.size();
+    rowStart.resize(V + 1);
+    lightEnd.resize(V);
+    std::vector<Edge> row;
+    for (size_t u = 0; u < V; ++u) {
+        row = g[u].neighbors;
+        std::sort(row.begin(), row.end(), [](const Edge& a, const Edge& b) {
+            return a.to != b.to ? a.to < b.to : a.cost < b.cost;
+        });
+        row.erase(std::unique(row.begin(), row.end(), [](const Edge& a, const Edge& b) {
+            return a.to == b.to;
+        }), row.end());
+        auto heavy = std::stable_partition(row.begin(), row.end(), [&](const Edge& e) {
+            return e.cost <= bucketWidth;
+        });
+
+        rowStart[u] = target.size();
+        lightEnd[u] = rowStart[u] + (heavy - row.begin());
+        for (const Edge& e : row) {
+            target.push_back(e.to);
+            weight.push_back(e.cost);
+        }
+    }
+    rowStart[V] = target.size();
+}
+
+float DeltaStepping::suggestDelta(const std::vector<Node>& g) {
+    std::vector<float> costs;
+    for (const Node& n : g) {
+        for (const Edge& e : n.neighbors) costs.push_back(e.cost);
+    }
+    if (costs.empty()) return 1.0f;
+    auto p90 = costs.begin() + costs.size() * 9 / 10;
+    std::nth_element(costs.begin(), p90, costs.end());
+    return *p90;
+}
+
+std::vector<float> DeltaStepping::distances(int source) {
+    auto t0 = std::chrono::steady_clock::now();
+    const size_t V = rowStart.size() - 1;
+    const int T = threads;
+    const float width = bucketWidth;
+    const size_t NONE = std::numeric_limits<size_t>::max();
+
+    std::vector<float> dist(V, INF);
+    std::vector<float> relaxedAt(V, INF);  // dist[v] when v last relaxed its light arcs
+    std::vector<size_t> settledIn(V, NONE); // bucket v was last removed from
+    std::vector<Worker> workers(T);
+    for (Worker& w : workers) w.outbox.resize(T);
+    std::vector<size_t> localMin(T);
+    std::atomic<size_t> pendingRound{0};
+    SpinBarrier barrier(T);
+
+    auto owner = [T](int v) { return (v >> 6) % T; };
+    auto bucketOf = [width](float d) { return static_cast<size_t>(d / width); };
+
+    dist[source] = 0.0f;
+    workers[owner(source)].buckets.resize(1);
+    workers[owner(source)].buckets[0].push_back(source);
+
+    report = DeltaSteppingStats();
+
+    auto run = [&](int t) {
+        Worker& self = workers[t];
+        size_t current = 0, round = 0;
+
+        // After everyone has written requests, apply the ones for our nodes
+        auto applyIncoming = [&]() {
+            barrier.wait();
+            bool pending = false;
+            for (Worker& from : workers) {
+                for (const Request& r : from.outbox[t]) {
+                    if (r.dist >= dist[r.node]) continue;
+                    dist[r.node] = r.dist;
+                    size_t b = std::max(current, bucketOf(r.dist));
+                    if (b >= self.buckets.size()) self.buckets.resize(b + 1);
+                    self.buckets[b].push_back(r.node);
+                    pending |= b == current;
+                }
+            }
+            if (pending) pendingRound.store(round, std::memory_order_relaxed);
+            barrier.wait();
+            for (auto& box : self.outbox) box.clear();
+        };
+        // Request dist[v] + cost for arcs [begin, end) of v
+        auto relax = [&](int v, size_t begin, size_t end) {
+            float dv = dist[v];
+            for (size_t k = begin; k < end; ++k) {
+                self.outbox[owner(target[k])].push_back({target[k], dv + weight[k]});
+            }
+            self.relaxations += end - begin;
+        };
+
+        while (true) {
+            // Everyone agrees on the smallest non-empty bucket
+            localMin[t] = NONE;
+            for (size_t b = current; b < self.buckets.size(); ++b) {
+                if (!self.buckets[b].empty()) { localMin[t] = b; break; }
+            }
+            barrier.wait();
+            size_t next = *std::min_element(localMin.begin(), localMin.end());
+            barrier.wait();
+            if (next == NONE) break;
+            current = next;
+            if (t == 0) report.buckets++;
+
+            // Light rounds until no node re-enters the bucket
+            self.settled.clear();
+            while (true) {
+                ++round;
+                self.frontier.clear();
+                if (current < self.buckets.size()) self.frontier.swap(self.buckets[current]);
+                for (int v : self.frontier) {
+                    if (relaxedAt[v] == dist[v]) continue; // duplicate entry
+                    relaxedAt[v] = dist[v];
+                    if (settledIn[v] != current) {
+                        settledIn[v] = current;
+                        self.settled.push_back(v);
+                    }
+                    relax(v, rowStart[v], lightEnd[v]);
+                }
+                applyIncoming();
+                if (t == 0) report.phases++;
+                if (pendingRound.load(std::memory_order_relaxed) != round) break;
+            }
+
+            // Heavy arcs once, from the final distances of everything settled here
+            ++round;
+            for (int v : self.settled) relax(v, lightEnd[v], rowStart[v + 1]);
+            applyIncoming();
+            if (t == 0) report.phases++;
+
+            // Float rounding can clamp a heavy request into this bucket; the next scan picks it up
+            if (current < self.buckets.size() && self.buckets[current].empty()) {
+                std::vector<int>().swap(self.buckets[current]);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(T - 1);
+    for (int t = 1; t < T; ++t) pool.emplace_back(run, t);
+    run(0);
+    for (auto& th : pool) th.join();
+
+    for (const Worker& w : workers) report.relaxations += w.relaxations;
+    report.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return dist;
+}
@@ -0,0 +1,131 @@
+#include "edge_attributes.h"
+#include "parallel.h"
+#include <algorithm>
+#include <limits>
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+// Arcs per parallel work item; large enough that scheduling is noise
+static const size_t ARC_BLOCK = 16384;
+
+EdgeAttributes::EdgeAttributes(const std::vector<Node>& g, int threads)
+    : graph(g), threads(threads > 0 ? threads : hardwareThreads())
+{
+    first.resize(g.size() + 1);
+    size_t arcs = 0;
+    for (size_t u = 0; u < g.size(); ++u) {
+        first[u] = arcs;
+        arcs += g[u].neighbors.size();
+    }
+    first[g.size()] = arcs;
+
+    run.resize(arcs);
+    rise.resize(arcs);
+    for (size_t u = 0; u < g.size(); ++u) {
+        size_t k = first[u];
+        for (const Edge& e : g[u].neighbors) {
+            run[k] = horizontalDistance(g[u].position, g[e.to].position);
+            rise[k] = g[e.to].position.y - g[u].position.y;
+            longest = std::max(longest, run[k]);
+            if (!(run[k] > 0.0f)) verticalArcs.push_back(k);
+            ++k;
+        }
+    }
+}
+
+void EdgeAttributes::setWetness(const std::vector<float>& perVertex) {
+    wet.resize(arcCount());
+    for (size_t u = 0; u < graph.size(); ++u) {
+        size_t k = first[u];
+        for (const Edge& e : graph[u].neighbors) {
+            wet[k] = run[k] * std::max(perVertex[u], perVertex[e.to]);
+            ++k;
+        }
+    }
+}
+
+void EdgeAttributes::evaluateRange(const CostProfile& p, size_t begin, size_t end, float* out) const {
+    // Branch-free float code over contiguous arrays so the compiler can vectorise it.
+    // Profile fields are copied to locals and pointers marked restrict, since out
+    // could otherwise alias them.
+    const float base = p.base, perLength = p.perLength, uphill = p.uphill, downhill = p.downhill;
+    const float climb = p.climb, descent = p.descent;
+    const float* __restrict runs = run.data();
+    const float* __restrict rises = rise.data();
+    float* __restrict costs = out;
+    for (size_t k = begin; k < end; ++k) {
+        float r = runs[k];
+        float magnitude = std::abs(rises[k]);
+        float up = 0.5f * (rises[k] + magnitude);      // max(rise, 0) without a branch
+        float down = 0.5f * (magnitude - rises[k]);    // max(-rise, 0)
+        costs[k] = base + (uphill * (up / r) + downhill * (down / r)) +
+                   perLength * r + climb * up + descent * down;
+    }
+
+    // Optional terms and rare cases in separate passes so they don't block vectorising the loop above
+    if (p.channel != 0.0f && !wet.empty()) {
+        const float channel = p.channel;
+        const float* __restrict wets = wet.data();
+        for (size_t k = begin; k < end; ++k) costs[k] += channel * wets[k];
+    }
+    if (p.maxGrade < INF) {
+        for (size_t k = begin; k < end; ++k) {
+            if (std::abs(rises[k]) > p.maxGrade * runs[k]) costs[k] = INF;
+        }
+    }
+    for (size_t k : verticalArcs) {
+        if (k < begin || k >= end) continue;
+        // No run: grade counts as 0, like edgeCost
+        float up = std::max(rises[k], 0.0f), down = std::max(-rises[k], 0.0f);
+        costs[k] = base + climb * up + descent * down;
+    }
+}
+
+void EdgeAttributes::evaluate(const CostProfile& profile, std::vector<float>& costs) const {
+    costs.resize(arcCount());
+    int blocks = static_cast<int>((arcCount() + ARC_BLOCK - 1) / ARC_BLOCK);
+    parallelFor(blocks, [&](int b, int) {
+        size_t begin = b * ARC_BLOCK;
+        evaluateRange(profile, begin, std::min(begin + ARC_BLOCK, arcCount()), costs.data());
+    }, threads);
+}
+
+void EdgeAttributes::evaluate(const std::vector<CostProfile>& profiles,
+                              std::vector<std::vector<float>>& costs) const {
+    costs.resize(profiles.size());
+    for (auto& c : costs) c.resize(arcCount());
+    // Block-major, so each block of attributes is read from cache once per profile
+    int blocks = static_cast<int>((arcCount() + ARC_BLOCK - 1) / ARC_BLOCK);
+    parallelFor(blocks, [&](int b, int) {
+        size_t begin = b * ARC_BLOCK;
+        size_t end = std::min(begin + ARC_BLOCK, arcCount());
+        for (size_t p = 0; p < profiles.size(); ++p) evaluateRange(profiles[p], begin, end, costs[p].data());
+    }, threads);
+}
+
+float EdgeAttributes::lowerBound(const CostProfile& p, const glm::vec3& a, const glm::vec3& goal) const {
+    // Every arc is at most maxStep long, so grade terms are at least rise / maxStep
+    // and base is at least run / maxStep; each term is subadditive along a route
+    float inv = longest > 0.0f ? 1.0f / longest : 0.0f;
+    float rise = goal.y - a.y;
+    float up = std::max(rise, 0.0f), down = std::max(-rise, 0.0f);
+    return BOUND_SHAVE * (horizontalDistance(a, goal) * (p.base * inv + p.perLength) +
+                          up * (p.uphill * inv + p.climb) + down * (p.downhill * inv + p.descent));
+}
+
+void applyCosts(std::vector<Node>& graph, const EdgeAttributes& attributes, const std::vector<float>& costs) {
+    const std::vector<size_t>& first = attributes.offsets();
+    for (size_t u = 0; u < graph.size(); ++u) {
+        size_t k = first[u];
+        for (Edge& e : graph[u].neighbors) e.cost = costs[k++];
+    }
+}
+
+std::vector<int> findPathProfile(const std::vector<Node>& graph, const EdgeAttributes& attributes,
+                                 const CostProfile& profile, const std::vector<float>& costs,
+                                 int startIndex, int goalIndex, SearchWorkspace& ws) {
+    const glm::vec3 goalPos = graph[goalIndex].position;
+    return findPathWithCosts(graph, startIndex, goalIndex, ws, ws.openSet,
+        [&](int u, const Edge& e) { return costs[attributes.arcIndex(u, e)]; },
+        [&](int v) { return attributes.lowerBound(profile, graph[v].position, goalPos); });
+}
@@ -0,0 +1,53 @@
+#include "flow_field.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+FlowField::FlowField(const std::vector<Node>& g, int goal)
+    : goalIndex(goal)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    cost.assign(g.size(), std::numeric_limits<float>::infinity());
+    next.assign(g.size(), -1);
+
+    QuaternaryHeapOpenSet openSet;
+    openSet.reset(g.size());
+    cost[goal] = 0.0f;
+    openSet.push(goal, 0.0f);
+    while (!openSet.empty()) {
+        int u = openSet.pop();
+        float du = cost[u];
+        farthest = du;
+        for (const Edge& e : g[u].neighbors) {
+            float tentative_g = du + e.cost;
+            if (tentative_g < cost[e.to]) {
+                cost[e.to] = tentative_g;
+                next[e.to] = u;   // the tree edge points back towards the goal
+                openSet.push(e.to, tentative_g);
+            }
+        }
+    }
+    buildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+std::vector<int> FlowField::routeFrom(int start) const {
+    if (!std::isfinite(cost[start])) return {};
+    std::vector<int> route;
+    for (int v = start; v != -1; v = next[v]) route.push_back(v);
+    return route;
+}
+
+std::vector<float> buildHeatmapVertexData(const std::vector<Node>& graph, const FlowField& field) {
+    std::vector<float> data;
+    data.reserve(graph.size() * 6);
+    float scale = field.maxCost() > 0.0f ? 1.0f / field.maxCost() : 0.0f;
+    for (size_t v = 0; v < graph.size(); ++v) {
+        float c = field.costToGoal(static_cast<int>(v));
+        if (!std::isfinite(c)) continue;
+        float t = c * scale;
+        glm::vec3 color = glm::mix(glm::vec3(0.1f, 0.3f, 0.95f), glm::vec3(0.95f, 0.15f, 0.1f), t);
+        const glm::vec3& p = graph[v].position;
+        data.insert(data.end(), {p.x, p.y + 0.015f, p.z, color.r, color.g, color.b});
+    }
+    return data;
+}
@@ -0,0 +1,70 @@
+#include "frame_timer.h"
+#include <algorithm>
+#include <numeric>
+
+FrameTimer::FrameTimer(int latency)
+    : slots(std::max(latency, 1))
+{
+    for (Slot& slot : slots) glGenQueries(1, &slot.query);
+}
+
+void FrameTimer::collect(Slot& slot) {
+    if (!slot.pending) return;
+    GLuint64 ns = 0;
+    glGetQueryObjectui64v(slot.query, GL_QUERY_RESULT, &ns);   // waits only if the GPU is that far behind
+    if (slot.record) gpuMs.push_back(ns * 1e-6);
+    slot.pending = false;
+}
+
+void FrameTimer::begin() {
+    Slot& slot = slots[frame % slots.size()];
+    collect(slot);
+    started = std::chrono::steady_clock::now();
+    glBeginQuery(GL_TIME_ELAPSED, slot.query);
+}
+
+void FrameTimer::end(bool record, bool sync) {
+    Slot& slot = slots[frame % slots.size()];
+    glEndQuery(GL_TIME_ELAPSED);
+    auto since = [&] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    };
+    if (record) cpuMs.push_back(since());
+    if (sync) {
+        glFinish();
+        if (record) syncedMs.push_back(since());
+    }
+    slot.pending = true;
+    slot.record = record;
+    ++frame;
+}
+
+void FrameTimer::finish() {
+    // Oldest first, so the GPU times stay in frame order
+    for (size_t n = 0; n < slots.size(); ++n) collect(slots[(frame + n) % slots.size()]);
+}
+
+void FrameTimer::release() {
+    for (Slot& slot : slots) {
+        if (slot.query != 0) glDeleteQueries(1, &slot.query);
+        slot.query = 0;
+        slot.pending = false;
+    }
+}
+
+FrameTimer::Summary FrameTimer::summarize(std::vector<double> times) {
+    Summary s;
+    s.frames = times.size();
+    if (times.empty()) return s;
+    std::sort(times.begin(), times.end());
+    auto percentile = [&](double p) {
+        size_t rank = static_cast<size_t>(p * (times.size() - 1) + 0.5);
+        return times[rank];
+    };
+    s.meanMs = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    s.p50Ms = percentile(0.50);
+    s.p90Ms = percentile(0.90);
+    s.p99Ms = percentile(0.99);
+    s.maxMs = times.back();
+    return s;
+}
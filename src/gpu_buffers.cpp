@@ -0,0 +1,47 @@
+#include "gpu_buffers.h"
+#include <algorithm>
+
+AppendBuffer::AppendBuffer(size_t initialBytes)
+    : capacity(std::max<size_t>(initialBytes, 64))
+{
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity, nullptr, GL_DYNAMIC_DRAW);
+}
+
+void AppendBuffer::release() {
+    if (buffer != 0) glDeleteBuffers(1, &buffer);
+    buffer = 0;
+    capacity = used = 0;
+}
+
+void AppendBuffer::reserve(size_t bytes) {
+    if (bytes <= capacity) return;
+    size_t grown = std::max(bytes, capacity * 2);
+
+    // Park the contents in a scratch buffer while the storage is reallocated under the same name
+    GLuint scratch = 0;
+    if (used > 0) {
+        glGenBuffers(1, &scratch);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+        glBufferData(GL_COPY_WRITE_BUFFER, used, nullptr, GL_STREAM_COPY);
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, grown, nullptr, GL_DYNAMIC_DRAW);
+    if (scratch != 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, scratch);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used);
+        glDeleteBuffers(1, &scratch);
+    }
+    capacity = grown;
+}
+
+void AppendBuffer::append(const void* data, size_t bytes) {
+    if (bytes == 0) return;
+    reserve(used + bytes);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, used, bytes, data);
+    used += bytes;
+}
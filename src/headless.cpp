@@ -0,0 +1,202 @@
+#include "headless.h"
+#include <GLFW/glfw3.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#ifdef PEAKGEN_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+static void printUsage(const char* program) {
+    std::cerr << "usage: " << program << " [--headless [--frames N] [--warmup N] [--size WxH] [--grid N]"
+              << " [--seed S] [--dump DIR] [--dump-every K]]\n";
+}
+
+bool HeadlessOptions::parse(int argc, char** argv) {
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        const char* value = a + 1 < argc ? argv[a + 1] : nullptr;
+        auto number = [&](int& out, int least) {
+            if (!value) return false;
+            char* end = nullptr;
+            long n = std::strtol(value, &end, 10);
+            if (*end != '\0' || n < least) return false;
+            out = static_cast<int>(n);
+            ++a;
+            return true;
+        };
+        bool ok = true;
+        if (arg == "--headless") {
+            enabled = true;
+        } else if (arg == "--frames") {
+            ok = number(frames, 1);
+        } else if (arg == "--warmup") {
+            ok = number(warmup, 0);
+        } else if (arg == "--grid") {
+            ok = number(grid, 2);
+        } else if (arg == "--dump-every") {
+            ok = number(dumpEvery, 1);
+        } else if (arg == "--seed") {
+            int s = 0;
+            ok = number(s, 0);
+            seed = static_cast<uint32_t>(s);
+        } else if (arg == "--size") {
+            ok = value && std::sscanf(value, "%dx%d", &width, &height) == 2 && width > 0 && height > 0;
+            ++a;
+        } else if (arg == "--dump") {
+            ok = value != nullptr;
+            if (ok) dumpDir = argv[++a];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Bad argument " << arg << "\n";
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef PEAKGEN_HAS_EGL
+static void* eglProc(const char* name) {
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+bool OffscreenContext::createEGL() {
+    auto getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (!getPlatformDisplay) return false;
+    EGLDisplay dpy = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    EGLint major = 0, minor = 0;
+    if (dpy == EGL_NO_DISPLAY || !eglInitialize(dpy, &major, &minor)) return false;
+
+    // Surfaceless and configless: the context draws only into framebuffer objects
+    const char* extensions = eglQueryString(dpy, EGL_EXTENSIONS);
+    if (!extensions || !std::strstr(extensions, "EGL_KHR_surfaceless_context") ||
+        !std::strstr(extensions, "EGL_KHR_no_config_context") || !eglBindAPI(EGL_OPENGL_API)) {
+        eglTerminate(dpy);
+        return false;
+    }
+    const EGLint attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext ctx = eglCreateContext(dpy, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+    if (ctx == EGL_NO_CONTEXT || !eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx)) {
+        if (ctx != EGL_NO_CONTEXT) eglDestroyContext(dpy, ctx);
+        eglTerminate(dpy);
+        return false;
+    }
+    display = dpy;
+    context = ctx;
+    api = "EGL " + std::to_string(major) + "." + std::to_string(minor) + " surfaceless";
+    return true;
+}
+#else
+bool OffscreenContext::createEGL() {
+    return false;
+}
+#endif
+
+bool OffscreenContext::create(int width, int height) {
+    w = width;
+    h = height;
+    if (createEGL()) return true;
+
+    if (!glfwInit()) {
+        std::cerr << "No offscreen context: no EGL surfaceless support and GLFW can't start\n";
+        return false;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    window = glfwCreateWindow(1, 1, "PeakGen headless", NULL, NULL);
+    if (!window) {
+        std::cerr << "No offscreen context: couldn't create a hidden GLFW window\n";
+        glfwTerminate();
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+    api = "hidden GLFW window";
+    return true;
+}
+
+GLADloadproc OffscreenContext::loader() const {
+#ifdef PEAKGEN_HAS_EGL
+    if (context) return (GLADloadproc)eglProc;
+#endif
+    return (GLADloadproc)glfwGetProcAddress;
+}
+
+bool OffscreenContext::createFramebuffer() {
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!complete) std::cerr << "Offscreen framebuffer incomplete\n";
+    bind();
+    return complete;
+}
+
+void OffscreenContext::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, w, h);
+}
+
+void OffscreenContext::readPixels(std::vector<uint8_t>& rgb) const {
+    std::vector<uint8_t> rows((size_t)w * h * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, rows.data());
+    // GL's first row is the bottom one
+    rgb.resize(rows.size());
+    const size_t stride = (size_t)w * 3;
+    for (int y = 0; y < h; ++y) {
+        std::memcpy(&rgb[(size_t)y * stride], &rows[(size_t)(h - 1 - y) * stride], stride);
+    }
+}
+
+void OffscreenContext::release() {
+    if (framebuffer != 0) {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteRenderbuffers(1, &depthBuffer);
+        framebuffer = colorBuffer = depthBuffer = 0;
+    }
+#ifdef PEAKGEN_HAS_EGL
+    if (context) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        context = display = nullptr;
+    }
+#endif
+    if (window) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        window = nullptr;
+    }
+}
+
+bool writePPM(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb) {
+    std::ofstream out(path, std::ios::binary);
+    out << "P6\n" << width << " " << height << "\n255\n";
+    out.write(reinterpret_cast<const char*>(rgb.data()), rgb.size());
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,168 @@
+#include "horizon.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "parallel.h"
+
+static const float HALF_PI = 1.57079632679f;
+
+// Grid steps of the first 8 azimuths, by increasing angle; the other 8 are their opposites
+static const int STEPS[8][2] = {{1, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 1}, {-1, 2}, {-1, 1}, {-2, 1}};
+
+// atan for x >= 0, within 1e-5 rad (minimax polynomial on [0, 1], reflected above 1)
+static float fastAtan(float x) {
+    bool inverted = x > 1.0f;
+    if (inverted) x = 1.0f / x;
+    float x2 = x * x;
+    float a = x * (0.99997726f + x2 * (-0.33262347f + x2 * (0.19354346f + x2 * (-0.11643287f +
+              x2 * (0.05265332f + x2 * -0.01172120f)))));
+    return inverted ? HALF_PI - a : a;
+}
+
+// Horizon slope as a byte: angle / (pi/2) * 255, 0 when nothing rises above the vertex
+static uint8_t quantizeSlope(float slope) {
+    if (!(slope > 0.0f)) return 0;
+    return static_cast<uint8_t>(fastAtan(slope) * (255.0f / HALF_PI) + 0.5f);
+}
+
+namespace {
+struct HullPoint {
+    float height;
+    int at;   // position along the line: row for steps that change rows, column otherwise
+};
+}
+
+// Add a vertex to the line's hull of the terrain ahead of it (already swept) and
+// return its horizon slope. Hull points that fall below the vertex's line to the
+// next one are popped; what is left on top is the point it sees at the steepest angle.
+static float pushHull(std::vector<HullPoint>& hull, float h, int at, float stepLength) {
+    while (hull.size() >= 2) {
+        const HullPoint& t = hull.back();
+        const HullPoint& s = hull[hull.size() - 2];
+        // slope(vertex, t) <= slope(t, s): t is not on the hull seen from the vertex
+        if ((t.height - h) * float(std::abs(s.at - t.at)) <= (s.height - t.height) * float(std::abs(t.at - at))) {
+            hull.pop_back();
+        } else {
+            break;
+        }
+    }
+    float slope = 0.0f;
+    if (!hull.empty()) slope = (hull.back().height - h) / (float(std::abs(hull.back().at - at)) * stepLength);
+    hull.push_back({h, at});
+    return slope;
+}
+
+HorizonMap::HorizonMap(const HeightGrid& grid, int threads)
+    : threads(threads)
+{
+    bake(grid);
+}
+
+// Each of the 16 directions is one sweep over the grid, row by row and along each row,
+// so heights are read and horizons written contiguously; the sight lines advance
+// side by side, each with its own hull. A line of step (a, b) is every vertex with
+// the same i * b - j * a. Sweeps run in parallel, writing one plane per direction;
+// the planes are then interleaved per vertex.
+void HorizonMap::bake(const HeightGrid& grid) {
+    auto t0 = std::chrono::steady_clock::now();
+    const int side = grid.side;
+    const size_t count = grid.size();
+    std::vector<uint8_t> planes(count * DIRECTIONS);
+
+    parallelFor(DIRECTIONS, [&](int d, int) {
+        const glm::ivec2 step = gridStep(d);
+        const int a = step.x, b = step.y;
+        const float stepLength = grid.spacing * std::sqrt(float(a * a + b * b));
+        const float* heights = grid.heights.data();
+        uint8_t* plane = &planes[(size_t)d * count];
+
+        if (a == 0) {
+            // Lines are the rows; look along j, so sweep each row from the end it faces
+            std::vector<HullPoint> hull;
+            for (int i = 0; i < side; ++i) {
+                hull.clear();
+                for (int n = 0; n < side; ++n) {
+                    int j = b > 0 ? side - 1 - n : n;
+                    plane[(size_t)i * side + j] = quantizeSlope(pushHull(hull, heights[i * side + j], j, stepLength));
+                }
+            }
+            return;
+        }
+
+        // Lines indexed by i * b - j * a, offset to start at 0
+        const int lo = std::min({0, (side - 1) * b, -(side - 1) * a, (side - 1) * (b - a)});
+        const int hi = std::max({0, (side - 1) * b, -(side - 1) * a, (side - 1) * (b - a)});
+        std::vector<std::vector<HullPoint>> hulls(hi - lo + 1);
+        for (int n = 0; n < side; ++n) {
+            int i = a > 0 ? side - 1 - n : n;   // rows ahead first
+            const float* row = heights + (size_t)i * side;
+            uint8_t* out = plane + (size_t)i * side;
+            for (int j = 0; j < side; ++j) {
+                std::vector<HullPoint>& hull = hulls[i * b - j * a - lo];
+                out[j] = quantizeSlope(pushHull(hull, row[j], i, stepLength / std::abs(a)));
+            }
+        }
+    }, threads);
+
+    // Interleave, and the open sky: a horizon at angle h hides sin^2(h) of the
+    // cosine-weighted sky in its sector
+    horizon.resize(count * DIRECTIONS);
+    sky.resize(count);
+    float hidden[256];
+    for (int q = 0; q < 256; ++q) {
+        float s = std::sin(q / 255.0f * HALF_PI);
+        hidden[q] = s * s / DIRECTIONS;
+    }
+    const int block = 4096;
+    parallelFor((int)((count + block - 1) / block), [&](int blk, int) {
+        size_t begin = (size_t)blk * block, end = std::min(count, begin + block);
+        for (size_t v = begin; v < end; ++v) {
+            uint8_t* h = &horizon[v * DIRECTIONS];
+            float covered = 0.0f;
+            for (int d = 0; d < DIRECTIONS; ++d) {
+                h[d] = planes[(size_t)d * count + v];
+                covered += hidden[h[d]];
+            }
+            sky[v] = static_cast<uint8_t>(std::lround((1.0f - covered) * 255.0f));
+        }
+    }, threads);
+
+    bakeTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+float HorizonMap::horizonAngle(int vertex, int direction) const {
+    return horizon[(size_t)vertex * DIRECTIONS + direction] / 255.0f * HALF_PI;
+}
+
+glm::ivec2 HorizonMap::gridStep(int d) {
+    const int* step = STEPS[d % 8];
+    int sign = d < 8 ? 1 : -1;
+    return glm::ivec2(sign * step[0], sign * step[1]);
+}
+
+glm::vec2 HorizonMap::direction(int d) {
+    return glm::normalize(glm::vec2(gridStep(d)));
+}
+
+void HorizonMap::sunWeights(const glm::vec3& toSun, float weights[DIRECTIONS]) {
+    const float TWO_PI = 4.0f * HALF_PI;
+    std::fill(weights, weights + DIRECTIONS, 0.0f);
+    auto azimuth = [&](int d) {
+        glm::vec2 dir = direction(d);
+        float a = std::atan2(dir.y, dir.x);
+        return a < 0.0f ? a + TWO_PI : a;
+    };
+    float sun = std::atan2(toSun.z, toSun.x);
+    if (sun < 0.0f) sun += TWO_PI;
+
+    // Azimuths increase with d, so the sun lies between d and d + 1 (wrapping at 2 pi)
+    int d = DIRECTIONS - 1;
+    while (d > 0 && azimuth(d) > sun) --d;
+    int next = (d + 1) % DIRECTIONS;
+    float from = azimuth(d), to = azimuth(next);
+    if (to <= from) to += TWO_PI;
+    if (sun < from) sun += TWO_PI;
+    float t = (sun - from) / (to - from);
+    weights[d] = 1.0f - t;
+    weights[next] = t;
+}
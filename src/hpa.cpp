@@ -0,0 +1,295 @@
+#include "hpa.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+HierarchicalPathfinder::HierarchicalPathfinder(const std::vector<Node>& g, int side, int clusterSize,
+                                               int transitionSpacing, int threads)
+    : graph(g), side(side), clusterSize(clusterSize)
+{
+    clustersPerSide = (side + clusterSize - 1) / clusterSize;
+    hScale = heuristicScale(graph);
+
+    clusters.resize(clustersPerSide * clustersPerSide);
+    for (int ci = 0; ci < clustersPerSide; ++ci) {
+        for (int cj = 0; cj < clustersPerSide; ++cj) {
+            Cluster& c = clusters[ci * clustersPerSide + cj];
+            c.row0 = ci * clusterSize;
+            c.col0 = cj * clusterSize;
+            c.rows = std::min(clusterSize, side - c.row0);
+            c.cols = std::min(clusterSize, side - c.col0);
+        }
+    }
+
+    buildTransitions(transitionSpacing);
+
+    // Intra-cluster tables are independent, so build them in parallel
+    int workers = threads > 0 ? threads : hardwareThreads();
+    std::vector<SearchWorkspace> scratch(workers);
+    parallelFor(clusterCount(), [&](int c, int w) {
+        computeCluster(c, scratch[w]);
+    }, workers);
+}
+
+int HierarchicalPathfinder::clusterOf(int node) const {
+    int row = node / side, col = node % side;
+    return (row / clusterSize) * clustersPerSide + col / clusterSize;
+}
+
+int HierarchicalPathfinder::localIndex(const Cluster& c, int node) const {
+    return (node / side - c.row0) * c.cols + (node % side - c.col0);
+}
+
+int HierarchicalPathfinder::globalIndex(const Cluster& c, int local) const {
+    return (c.row0 + local / c.cols) * side + c.col0 + local % c.cols;
+}
+
+size_t HierarchicalPathfinder::abstractEdgeCount() const {
+    size_t count = 0;
+    for (const AbstractNode& a : abstractNodes) count += a.inter.size();
+    for (const Cluster& c : clusters) {
+        size_t k = c.transitions.size();
+        if (k > 1) count += k * (k - 1);
+    }
+    return count;
+}
+
+void HierarchicalPathfinder::buildTransitions(int transitionSpacing) {
+    struct Crossing {
+        int from, to;
+        float cost;
+    };
+
+    // Group border-crossing edges by cluster pair (each undirected edge once)
+    std::map<int64_t, std::vector<Crossing>> borders;
+    for (int u = 0; u < (int)graph.size(); ++u) {
+        int cu = clusterOf(u);
+        for (const Edge& e : graph[u].neighbors) {
+            int cv = clusterOf(e.to);
+            if (cu < cv) borders[(int64_t)cu * clusterCount() + cv].push_back({u, e.to, e.cost});
+        }
+    }
+
+    abstractOf.assign(graph.size(), -1);
+    auto abstractFor = [&](int node) {
+        if (abstractOf[node] < 0) {
+            abstractOf[node] = static_cast<int>(abstractNodes.size());
+            abstractNodes.push_back({node, clusterOf(node), -1, {}});
+        }
+        return abstractOf[node];
+    };
+    auto link = [&](int a, int b, float cost) {
+        for (InterEdge& e : abstractNodes[a].inter) {
+            if (e.to == b) { e.cost = std::min(e.cost, cost); return; }
+        }
+        abstractNodes[a].inter.push_back({b, cost});
+    };
+
+    int spacing = std::max(1, transitionSpacing);
+    for (auto& entry : borders) {
+        std::vector<Crossing>& edges = entry.second;
+        std::sort(edges.begin(), edges.end(), [](const Crossing& a, const Crossing& b) {
+            return a.from != b.from ? a.from < b.from : a.to != b.to ? a.to < b.to : a.cost < b.cost;
+        });
+        // buildGraph emits shared triangle edges twice; keep the cheapest copy
+        edges.erase(std::unique(edges.begin(), edges.end(), [](const Crossing& a, const Crossing& b) {
+            return a.from == b.from && a.to == b.to;
+        }), edges.end());
+
+        // Spread transitions along the border, always keeping both ends
+        for (size_t i = 0; i < edges.size(); ++i) {
+            bool keep = i % spacing == 0 || i + 1 == edges.size();
+            if (!keep) continue;
+            int a = abstractFor(edges[i].from);
+            int b = abstractFor(edges[i].to);
+            link(a, b, edges[i].cost);
+            link(b, a, edges[i].cost);
+        }
+    }
+
+    for (int a = 0; a < (int)abstractNodes.size(); ++a) {
+        Cluster& c = clusters[abstractNodes[a].cluster];
+        abstractNodes[a].slot = static_cast<int>(c.transitions.size());
+        c.transitions.push_back(a);
+    }
+}
+
+void HierarchicalPathfinder::searchCluster(const Cluster& c, int source, int goal,
+                                           SearchWorkspace& scratch, size_t* expanded) const {
+    size_t n = static_cast<size_t>(c.rows) * c.cols;
+    scratch.beginQuery(n);
+    scratch.openSet.reset(n);
+
+    const glm::vec3 goalPos = goal >= 0 ? graph[goal].position : glm::vec3(0.0f);
+    float weight = goal >= 0 ? hScale : 0.0f;
+    int goalLocal = goal >= 0 ? localIndex(c, goal) : -1;
+
+    int s = localIndex(c, source);
+    scratch.set(s, 0.0f, -1);
+    scratch.openSet.push(s, weight * glm::length(graph[source].position - goalPos));
+
+    while (!scratch.openSet.empty()) {
+        int u = scratch.openSet.pop();
+        scratch.close(u);
+        if (expanded) ++*expanded;
+        if (u == goalLocal) break;
+
+        int gu = globalIndex(c, u);
+        for (const Edge& e : graph[gu].neighbors) {
+            int row = e.to / side - c.row0, col = e.to % side - c.col0;
+            if (row < 0 || row >= c.rows || col < 0 || col >= c.cols) continue; // leaves the cluster
+            int v = row * c.cols + col;
+            float tentative_g = scratch.dist(u) + e.cost;
+            if (tentative_g < scratch.dist(v) && !scratch.isClosed(v)) {
+                scratch.set(v, tentative_g, u);
+                scratch.openSet.push(v, tentative_g + weight * glm::length(graph[e.to].position - goalPos));
+            }
+        }
+    }
+}
+
+void HierarchicalPathfinder::computeCluster(int cluster, SearchWorkspace& scratch) {
+    Cluster& c = clusters[cluster];
+    size_t k = c.transitions.size();
+    c.costs.assign(k * k, INF);
+    for (size_t i = 0; i < k; ++i) {
+        AbstractNode& a = abstractNodes[c.transitions[i]];
+        searchCluster(c, a.node, -1, scratch, nullptr);
+        for (size_t j = 0; j < k; ++j) {
+            c.costs[i * k + j] = scratch.dist(localIndex(c, abstractNodes[c.transitions[j]].node));
+        }
+    }
+}
+
+void HierarchicalPathfinder::refreshInterCosts(int cluster) {
+    for (int a : clusters[cluster].transitions) {
+        for (InterEdge& ie : abstractNodes[a].inter) {
+            float cost = INF;
+            for (const Edge& e : graph[abstractNodes[a].node].neighbors) {
+                if (e.to == abstractNodes[ie.to].node) cost = std::min(cost, e.cost);
+            }
+            ie.cost = cost;
+            for (InterEdge& back : abstractNodes[ie.to].inter) {
+                if (back.to == a) back.cost = cost;
+            }
+        }
+    }
+}
+
+void HierarchicalPathfinder::updateCluster(int cluster) {
+    refreshInterCosts(cluster);
+    computeCluster(cluster, querySearch);
+}
+
+std::vector<int> HierarchicalPathfinder::refineSegment(int from, int to, size_t* expanded) {
+    const Cluster& c = clusters[clusterOf(from)];
+    searchCluster(c, from, to, querySearch, expanded);
+
+    std::vector<int> segment;
+    for (int v = localIndex(c, to); v != -1; v = querySearch.prev(v)) {
+        segment.push_back(globalIndex(c, v));
+    }
+    std::reverse(segment.begin(), segment.end());
+    return segment;
+}
+
+std::vector<int> HierarchicalPathfinder::findPath(int start, int goal, HpaQueryStats* stats) {
+    HpaQueryStats local;
+    if (!stats) stats = &local;
+    *stats = HpaQueryStats();
+
+    const int A = static_cast<int>(abstractNodes.size());
+    const int tempStart = A, tempGoal = A + 1;
+    const Cluster& cs = clusters[clusterOf(start)];
+    const Cluster& cg = clusters[clusterOf(goal)];
+
+    // Connect start and goal to the transitions of their own clusters
+    searchCluster(cs, start, -1, querySearch, nullptr);
+    std::vector<float> startCost(cs.transitions.size());
+    for (size_t i = 0; i < cs.transitions.size(); ++i) {
+        startCost[i] = querySearch.dist(localIndex(cs, abstractNodes[cs.transitions[i]].node));
+    }
+    float direct = &cs == &cg ? querySearch.dist(localIndex(cs, goal)) : INF;
+
+    searchCluster(cg, goal, -1, querySearch, nullptr);
+    std::vector<float> goalCost(A + 2, INF); // edge cost into tempGoal
+    for (int a : cg.transitions) {
+        goalCost[a] = querySearch.dist(localIndex(cg, abstractNodes[a].node));
+    }
+    goalCost[tempStart] = direct;
+
+    // A* over the abstract graph
+    const glm::vec3& goalPos = graph[goal].position;
+    auto position = [&](int a) -> const glm::vec3& {
+        return a == tempStart ? graph[start].position : a == tempGoal ? goalPos : graph[abstractNodes[a].node].position;
+    };
+
+    abstractWs.beginQuery(A + 2);
+    QuaternaryHeapOpenSet& openSet = abstractWs.openSet;
+    openSet.reset(A + 2);
+    abstractWs.set(tempStart, 0.0f, -1);
+    openSet.push(tempStart, hScale * glm::length(position(tempStart) - goalPos));
+
+    auto relax = [&](int u, int v, float cost) {
+        float tentative_g = abstractWs.dist(u) + cost;
+        if (tentative_g < abstractWs.dist(v) && !abstractWs.isClosed(v)) {
+            abstractWs.set(v, tentative_g, u);
+            openSet.push(v, tentative_g + hScale * glm::length(position(v) - goalPos));
+        }
+    };
+
+    while (!openSet.empty()) {
+        int u = openSet.pop();
+        abstractWs.close(u);
+        ++stats->abstractExpanded;
+        if (u == tempGoal) break;
+
+        if (goalCost[u] < INF) relax(u, tempGoal, goalCost[u]);
+        if (u == tempStart) {
+            for (size_t i = 0; i < cs.transitions.size(); ++i) {
+                if (startCost[i] < INF) relax(u, cs.transitions[i], startCost[i]);
+            }
+            continue;
+        }
+
+        const AbstractNode& a = abstractNodes[u];
+        for (const InterEdge& e : a.inter) relax(u, e.to, e.cost);
+
+        const Cluster& c = clusters[a.cluster];
+        size_t k = c.transitions.size();
+        size_t row = a.slot;
+        for (size_t j = 0; j < k; ++j) {
+            float cost = c.costs[row * k + j];
+            if (j != row && cost < INF) relax(u, c.transitions[j], cost);
+        }
+    }
+
+    if (abstractWs.dist(tempGoal) == INF) return {};
+    stats->abstractCost = abstractWs.dist(tempGoal);
+
+    // Refine each abstract hop at full resolution
+    std::vector<int> hops = abstractWs.pathTo(tempGoal);
+    std::vector<int> waypoints;
+    for (int a : hops) {
+        int node = a == tempStart ? start : a == tempGoal ? goal : abstractNodes[a].node;
+        if (waypoints.empty() || waypoints.back() != node) waypoints.push_back(node);
+    }
+
+    std::vector<int> path = {start};
+    for (size_t i = 0; i + 1 < waypoints.size(); ++i) {
+        int from = waypoints[i], to = waypoints[i + 1];
+        if (clusterOf(from) != clusterOf(to)) {
+            path.push_back(to); // inter-cluster hop is a single edge
+            continue;
+        }
+        std::vector<int> segment = refineSegment(from, to, &stats->refineExpanded);
+        path.insert(path.end(), segment.begin() + 1, segment.end());
+    }
+
+    stats->cost = pathCost(graph, path);
+    return path;
+}
\ No newline at end of file
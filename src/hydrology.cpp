@@ -0,0 +1,482 @@
+#include "hydrology.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "open_set.h"
+#include "parallel.h"
+
+static const int DI[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+static const int DJ[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+namespace {
+
+// Priority queue for the floods. Their keys never go below the last one popped,
+// so a radix heap works: entries sit in buckets by the highest bit in which
+// they differ from the last popped key, and a bucket is only split when the
+// lower ones run dry. O(1) amortised push and O(log range) pop, with no
+// per-node position table to maintain.
+class MonotoneQueue {
+public:
+    bool empty() const { return count == 0; }
+
+    void clear() {
+        for (auto& b : buckets) b.clear();
+        count = 0;
+        last = 0;
+    }
+
+    void push(int v, float height) {
+        uint32_t key = orderedBits(height);
+        buckets[bucketOf(key)].push_back({key, v});
+        ++count;
+    }
+
+    int pop() {
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) ++i;
+            uint32_t lowest = buckets[i][0].key;
+            for (const Entry& e : buckets[i]) lowest = std::min(lowest, e.key);
+            last = lowest;
+            for (const Entry& e : buckets[i]) buckets[bucketOf(e.key)].push_back(e);
+            buckets[i].clear();
+        }
+        int v = buckets[0].back().v;
+        buckets[0].pop_back();
+        --count;
+        return v;
+    }
+
+private:
+    struct Entry {
+        uint32_t key;
+        int v;
+    };
+    std::vector<Entry> buckets[33];
+    uint32_t last = 0;
+    size_t count = 0;
+
+    // Float order as unsigned order
+    static uint32_t orderedBits(float height) {
+        uint32_t bits;
+        std::memcpy(&bits, &height, sizeof bits);
+        return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+    }
+
+    int bucketOf(uint32_t key) const {
+        uint32_t diff = key ^ last;
+        if (diff == 0) return 0;
+#if defined(_MSC_VER)
+        unsigned long bit;
+        _BitScanReverse(&bit, diff);
+        return static_cast<int>(bit) + 1;
+#else
+        return 32 - __builtin_clz(diff);
+#endif
+    }
+};
+
+} // namespace
+
+static double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+std::vector<float> fillDepressions(const HeightGrid& grid) {
+    // Work on a copy with a one-cell ring of closed cells around it, so the
+    // neighbours of a cell are fixed index offsets with no bounds checks
+    const int side = grid.side;
+    const int stride = side + 2;
+    std::vector<float> level(static_cast<size_t>(stride) * stride, 0.0f);
+    std::vector<char> closed(level.size(), 1);
+    for (int i = 0; i < side; ++i) {
+        std::copy_n(&grid.heights[static_cast<size_t>(i) * side], side, &level[(i + 1) * stride + 1]);
+        std::fill_n(&closed[(i + 1) * stride + 1], side, 0);
+    }
+    int offsets[8];
+    for (int d = 0; d < 8; ++d) offsets[d] = DI[d] * stride + DJ[d];
+
+    MonotoneQueue open;
+    std::vector<int> pit;     // FIFO of cells raised to their neighbour's level
+    std::vector<int> slope;   // FIFO of cells above a drained neighbour, already final
+    size_t pitHead = 0, slopeHead = 0;
+
+    for (int i = 1; i <= side; ++i) {
+        for (int j = 1; j <= side; ++j) {
+            if (i == 1 || j == 1 || i == side || j == side) {
+                int v = i * stride + j;
+                closed[v] = 1;
+                open.push(v, level[v]);
+            }
+        }
+    }
+
+    // A cell higher than a drained neighbour drains through it and keeps its
+    // height, so it is final without a trip through the queue (Zhou et al. 2016).
+    // Such slope cells trace further uphill directly; one only goes into the
+    // queue if it also borders an open cell no higher than itself, whose level
+    // still depends on the flood order.
+    while (!open.empty()) {
+        int c = open.pop();
+        pit.clear();
+        slope.clear();
+        pitHead = slopeHead = 0;
+        while (true) {
+            bool traced = false;
+            if (pitHead < pit.size()) {
+                c = pit[pitHead++];
+            } else if (slopeHead < slope.size()) {
+                c = slope[slopeHead++];
+                traced = true;
+            }
+
+            bool spills = false;
+            for (int d = 0; d < 8; ++d) {
+                int v = c + offsets[d];
+                if (closed[v]) continue;
+                if (level[v] > level[c]) {
+                    closed[v] = 1;
+                    slope.push_back(v);
+                } else if (traced) {
+                    spills = true;
+                } else {
+                    closed[v] = 1;
+                    level[v] = level[c];
+                    pit.push_back(v);
+                }
+            }
+            if (spills) open.push(c, level[c]);
+            if (pitHead == pit.size() && slopeHead == slope.size()) break;
+        }
+    }
+
+    std::vector<float> filled(grid.size());
+    for (int i = 0; i < side; ++i) {
+        std::copy_n(&level[(i + 1) * stride + 1], side, &filled[static_cast<size_t>(i) * side]);
+    }
+    return filled;
+}
+
+namespace {
+
+const int OCEAN = 0;   // label of everything draining off the map edge
+
+// Lowest contact height between two labels
+struct SpillEdge {
+    int a, b;
+    float height;
+};
+
+struct TileFlood {
+    int labelCount = 0;               // local labels 1..labelCount (0 is OCEAN)
+    std::vector<SpillEdge> edges;     // local labels
+};
+
+} // namespace
+
+std::vector<float> fillDepressionsTiled(const HeightGrid& grid, int tileSize, int threads) {
+    const int side = grid.side;
+    const int n = side * side;
+    tileSize = std::max(tileSize, 8);
+    const int tilesPerSide = (side + tileSize - 1) / tileSize;
+    const int tileCount = tilesPerSide * tilesPerSide;
+
+    std::vector<float> filled(grid.heights);
+    std::vector<int> label(n, -1);   // tile-local label per cell
+    std::vector<TileFlood> tiles(tileCount);
+    auto tileBounds = [&](int t, int& i0, int& i1, int& j0, int& j1) {
+        i0 = (t / tilesPerSide) * tileSize;
+        j0 = (t % tilesPerSide) * tileSize;
+        i1 = std::min(i0 + tileSize, side);
+        j1 = std::min(j0 + tileSize, side);
+    };
+
+    // 1. Flood every tile from its own border; each tile only touches its own cells
+    parallelFor(tileCount, [&](int t, int) {
+        int i0, i1, j0, j1;
+        tileBounds(t, i0, i1, j0, j1);
+        int w = j1 - j0;
+        auto global = [&](int local) { return (i0 + local / w) * side + j0 + local % w; };
+
+        MonotoneQueue open;
+        std::vector<char> done((i1 - i0) * w, 0);
+        std::vector<int> pit;
+        size_t pitHead = 0;
+        std::unordered_map<uint64_t, float> contacts;
+        TileFlood& flood = tiles[t];
+
+        for (int i = i0; i < i1; ++i) {
+            for (int j = j0; j < j1; ++j) {
+                if (i != i0 && j != j0 && i != i1 - 1 && j != j1 - 1) continue;
+                int v = i * side + j;
+                if (i == 0 || j == 0 || i == side - 1 || j == side - 1) label[v] = OCEAN;
+                open.push((i - i0) * w + (j - j0), filled[v]);
+            }
+        }
+
+        while (!open.empty() || pitHead < pit.size()) {
+            int local;
+            if (pitHead < pit.size()) {
+                local = pit[pitHead++];
+            } else {
+                pit.clear();
+                pitHead = 0;
+                local = open.pop();
+            }
+            if (done[local]) continue;
+            done[local] = 1;
+            int c = global(local);
+            if (label[c] == -1) label[c] = ++flood.labelCount; // a border cell nothing reached first
+
+            int ci = c / side, cj = c % side;
+            for (int d = 0; d < 8; ++d) {
+                int ni = ci + DI[d], nj = cj + DJ[d];
+                if (ni < i0 || nj < j0 || ni >= i1 || nj >= j1) continue;
+                int v = ni * side + nj;
+                if (label[v] != -1) {
+                    if (label[v] != label[c]) {
+                        int a = std::min(label[v], label[c]), b = std::max(label[v], label[c]);
+                        uint64_t key = (static_cast<uint64_t>(a) << 32) | static_cast<uint32_t>(b);
+                        float height = std::max(filled[c], filled[v]);
+                        auto it = contacts.find(key);
+                        if (it == contacts.end()) contacts.emplace(key, height);
+                        else it->second = std::min(it->second, height);
+                    }
+                    continue;
+                }
+                label[v] = label[c];
+                int vLocal = (ni - i0) * w + (nj - j0);
+                if (filled[v] <= filled[c]) {
+                    filled[v] = filled[c];
+                    pit.push_back(vLocal);
+                } else {
+                    open.push(vLocal, filled[v]);
+                }
+            }
+        }
+        flood.edges.reserve(contacts.size());
+        for (const auto& [key, height] : contacts) {
+            flood.edges.push_back({static_cast<int>(key >> 32), static_cast<int>(key & 0xffffffffu), height});
+        }
+    }, threads);
+
+    // 2. Global label ids: OCEAN stays 0, tile t's labels follow the previous tiles'
+    std::vector<int> base(tileCount + 1, 1);
+    for (int t = 0; t < tileCount; ++t) base[t + 1] = base[t] + tiles[t].labelCount;
+    const int labelCount = base[tileCount];
+    auto globalLabel = [&](int v) {
+        int i = v / side, j = v % side;
+        int t = (i / tileSize) * tilesPerSide + j / tileSize;
+        return label[v] == OCEAN ? OCEAN : base[t] + label[v] - 1;
+    };
+
+    std::vector<std::vector<std::pair<int, float>>> graph(labelCount);
+    auto connect = [&](int a, int b, float height) {
+        if (a == b) return;
+        graph[a].push_back({b, height});
+        graph[b].push_back({a, height});
+    };
+    for (int t = 0; t < tileCount; ++t) {
+        for (const SpillEdge& e : tiles[t].edges) {
+            connect(e.a == OCEAN ? OCEAN : base[t] + e.a - 1, e.b == OCEAN ? OCEAN : base[t] + e.b - 1, e.height);
+        }
+    }
+    // Contacts across tile borders, between cells that were never raised
+    for (int border = tileSize; border < side; border += tileSize) {
+        for (int k = 0; k < side; ++k) {
+            for (int dk = -1; dk <= 1; ++dk) {
+                int k2 = k + dk;
+                if (k2 < 0 || k2 >= side) continue;
+                int a = (border - 1) * side + k, b = border * side + k2;   // across a row border
+                connect(globalLabel(a), globalLabel(b), std::max(filled[a], filled[b]));
+                a = k * side + border - 1, b = k2 * side + border;          // across a column border
+                connect(globalLabel(a), globalLabel(b), std::max(filled[a], filled[b]));
+            }
+        }
+    }
+
+    // 3. Level each label must reach to spill off the map: minimax path from OCEAN
+    std::vector<float> spill(labelCount, std::numeric_limits<float>::infinity());
+    std::vector<char> settled(labelCount, 0);
+    QuaternaryHeapOpenSet open;
+    open.reset(labelCount);
+    spill[OCEAN] = -std::numeric_limits<float>::infinity();
+    open.push(OCEAN, spill[OCEAN]);
+    while (!open.empty()) {
+        int u = open.pop();
+        settled[u] = 1;
+        for (const auto& [v, height] : graph[u]) {
+            float level = std::max(spill[u], height);
+            if (!settled[v] && level < spill[v]) {
+                spill[v] = level;
+                open.push(v, level);
+            }
+        }
+    }
+
+    // 4. Raise every cell to its label's spill level
+    parallelFor(side, [&](int i, int) {
+        for (int j = 0; j < side; ++j) {
+            int v = i * side + j;
+            filled[v] = std::max(filled[v], spill[globalLabel(v)]);
+        }
+    }, threads, 16);
+    return filled;
+}
+
+std::vector<int> flowDirections(const HeightGrid& grid, const std::vector<float>& filled, int threads) {
+    const int side = grid.side;
+    const int FLAT = -2;
+    std::vector<int> downstream(filled.size(), -1);
+    const float diagonal = 1.0f / std::sqrt(2.0f);
+    int offsets[8];
+    float weights[8];
+    for (int d = 0; d < 8; ++d) {
+        offsets[d] = DI[d] * side + DJ[d];
+        weights[d] = DI[d] != 0 && DJ[d] != 0 ? diagonal : 1.0f;
+    }
+
+    // Edge rows and columns are outlets; interior neighbours are fixed offsets
+    parallelFor(std::max(side - 2, 0), [&](int row, int) {
+        const int i = row + 1;
+        for (int c = i * side + 1; c < (i + 1) * side - 1; ++c) {
+            int best = FLAT;
+            float steepest = 0.0f;
+            for (int d = 0; d < 8; ++d) {
+                float drop = (filled[c] - filled[c + offsets[d]]) * weights[d];
+                if (drop > steepest) {
+                    steepest = drop;
+                    best = c + offsets[d];
+                }
+            }
+            downstream[c] = best;
+        }
+    }, threads, 16);
+
+    // Flats: breadth-first from their edges, where a flat cell touches a drained
+    // cell of the same height, inwards; each cell flows back the way the search came
+    std::vector<int> flats, queue;
+    for (int c = 0; c < (int)filled.size(); ++c) {
+        if (downstream[c] == FLAT) flats.push_back(c);
+    }
+    for (int c : flats) {
+        for (int d = 0; d < 8; ++d) {
+            int v = c + offsets[d];   // flats are interior, so in range
+            if (downstream[v] != FLAT && filled[v] == filled[c]) {
+                downstream[c] = v;
+                queue.push_back(c);
+                break;
+            }
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int c = queue[head];
+        for (int d = 0; d < 8; ++d) {
+            int v = c + offsets[d];
+            if (downstream[v] == FLAT && filled[v] == filled[c]) {
+                downstream[v] = c;
+                queue.push_back(v);
+            }
+        }
+    }
+    // Filling leaves no undrained flats; anything left is a map edge artefact
+    for (int& d : downstream) {
+        if (d == FLAT) d = -1;
+    }
+    return downstream;
+}
+
+// From every source walk down, passing the area on, until reaching a cell that
+// still waits for another upstream branch (that branch carries on later)
+static std::vector<uint32_t> accumulateSequential(const std::vector<int>& downstream) {
+    const size_t n = downstream.size();
+    std::vector<uint32_t> accumulation(n, 1u);
+    std::vector<uint8_t> inflow(n, 0);
+    for (int d : downstream) {
+        if (d >= 0) ++inflow[d];
+    }
+    std::vector<int> sources;
+    for (size_t v = 0; v < n; ++v) {
+        if (inflow[v] == 0) sources.push_back(static_cast<int>(v));
+    }
+    for (int s : sources) {
+        for (int v = s, d = downstream[v]; d >= 0; v = d, d = downstream[v]) {
+            accumulation[d] += accumulation[v];
+            if (--inflow[d] != 0) break;
+        }
+    }
+    return accumulation;
+}
+
+std::vector<uint32_t> flowAccumulation(const std::vector<int>& downstream, int threads) {
+    // The atomics cost more than they save on one thread
+    if (threads <= 0) threads = hardwareThreads();
+    if (threads == 1) return accumulateSequential(downstream);
+
+    const int n = static_cast<int>(downstream.size());
+    const int grain = 1 << 16;
+    std::vector<std::atomic<uint32_t>> area(n);
+    std::vector<std::atomic<uint8_t>> inflow(n);   // at most 8 neighbours drain into a cell
+    parallelFor(n, [&](int v, int) {
+        area[v].store(1u, std::memory_order_relaxed);
+        inflow[v].store(0, std::memory_order_relaxed);
+    }, threads, grain);
+    parallelFor(n, [&](int v, int) {
+        if (downstream[v] >= 0) inflow[downstream[v]].fetch_add(1, std::memory_order_relaxed);
+    }, threads, grain);
+
+    std::vector<int> sources;
+    for (int v = 0; v < n; ++v) {
+        if (inflow[v].load(std::memory_order_relaxed) == 0) sources.push_back(v);
+    }
+
+    // Same walks in parallel: whichever walk delivers a cell's last inflow carries on from it
+    parallelFor(static_cast<int>(sources.size()), [&](int k, int) {
+        for (int v = sources[k], d = downstream[v]; d >= 0; v = d, d = downstream[v]) {
+            area[d].fetch_add(area[v].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            if (inflow[d].fetch_sub(1, std::memory_order_acq_rel) != 1) break;
+        }
+    }, threads, 4096);
+
+    std::vector<uint32_t> accumulation(n);
+    parallelFor(n, [&](int v, int) { accumulation[v] = area[v].load(std::memory_order_relaxed); }, threads, grain);
+    return accumulation;
+}
+
+DrainageNetwork analyzeDrainage(const HeightGrid& grid, int tileSize, int threads) {
+    DrainageNetwork net;
+    auto t0 = std::chrono::steady_clock::now();
+    net.filled = tileSize > 0 ? fillDepressionsTiled(grid, tileSize, threads) : fillDepressions(grid);
+    net.fillMs = msSince(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    net.downstream = flowDirections(grid, net.filled, threads);
+    net.directionMs = msSince(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    net.accumulation = flowAccumulation(net.downstream, threads);
+    net.accumulationMs = msSince(t0);
+    return net;
+}
+
+std::vector<float> channelStrength(const std::vector<uint32_t>& accumulation, uint32_t minArea) {
+    uint32_t largest = 1;
+    for (uint32_t a : accumulation) largest = std::max(largest, a);
+    minArea = std::max(minArea, 1u);
+    float range = std::log(static_cast<float>(largest) / minArea);
+    std::vector<float> strength(accumulation.size(), 0.0f);
+    if (!(range > 0.0f)) return strength;
+
+    for (size_t v = 0; v < accumulation.size(); ++v) {
+        if (accumulation[v] < minArea) continue;
+        strength[v] = std::log(static_cast<float>(accumulation[v]) / minArea) / range;
+    }
+    return strength;
+}
@@ -0,0 +1,177 @@
+#include "incremental.h"
+#include <algorithm>
+#include <limits>
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+void IncrementalPathfinder::Queue::set(int v, Key key) {
+    int slot = pos[v];
+    if (slot < 0) {
+        heap.push_back({v, key});
+        pos[v] = static_cast<int>(heap.size() - 1);
+        siftUp(static_cast<int>(heap.size() - 1));
+        return;
+    }
+    Key old = heap[slot].key;
+    heap[slot].key = key;
+    if (key < old) siftUp(slot);
+    else siftDown(slot);
+}
+
+void IncrementalPathfinder::Queue::remove(int v) {
+    int slot = pos[v];
+    if (slot < 0) return;
+    pos[v] = -1;
+    Entry last = heap.back();
+    heap.pop_back();
+    if (slot == static_cast<int>(heap.size())) return;
+    Key old = heap[slot].key;
+    moveTo(slot, last);
+    if (last.key < old) siftUp(slot);
+    else siftDown(slot);
+}
+
+void IncrementalPathfinder::Queue::siftUp(int i) {
+    Entry e = heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!(e.key < heap[parent].key)) break;
+        moveTo(i, heap[parent]);
+        i = parent;
+    }
+    moveTo(i, e);
+}
+
+void IncrementalPathfinder::Queue::siftDown(int i) {
+    Entry e = heap[i];
+    int n = static_cast<int>(heap.size());
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && heap[child + 1].key < heap[child].key) ++child;
+        if (!(heap[child].key < e.key)) break;
+        moveTo(i, heap[child]);
+        i = child;
+    }
+    moveTo(i, e);
+}
+
+IncrementalPathfinder::IncrementalPathfinder(const std::vector<Node>& g, int s, int goal)
+    : graph(g), startIndex(s), goalIndex(goal)
+{
+    float longest = maxHorizontalStep(graph);
+    hScale = longest > 0.0f ? BOUND_SHAVE / longest : 0.0f;
+
+    this->g.assign(graph.size(), INF);
+    rhs.assign(graph.size(), INF);
+    open.init(graph.size());
+
+    rhs[startIndex] = 0.0f;
+    open.set(startIndex, keyOf(startIndex));
+}
+
+float IncrementalPathfinder::heuristic(int v) const {
+    glm::vec3 d = graph[goalIndex].position - graph[v].position;
+    return hScale * glm::length(glm::vec2(d.x, d.z));
+}
+
+IncrementalPathfinder::Key IncrementalPathfinder::keyOf(int v) const {
+    float best = std::min(g[v], rhs[v]);
+    return {best + heuristic(v), best};
+}
+
+bool IncrementalPathfinder::finished() const {
+    return (open.empty() || !(open.topKey() < keyOf(goalIndex))) && rhs[goalIndex] == g[goalIndex];
+}
+
+void IncrementalPathfinder::updateVertex(int v, std::vector<int>* frontier) {
+    if (v != startIndex) {
+        // Costs are symmetric, so v's own arcs give the cost of arriving from each neighbour
+        float best = INF;
+        for (const Edge& e : graph[v].neighbors) best = std::min(best, g[e.to] + e.cost);
+        rhs[v] = best;
+    }
+    if (g[v] != rhs[v]) {
+        open.set(v, keyOf(v));
+        if (frontier) frontier->push_back(v);
+    } else {
+        open.remove(v);
+    }
+}
+
+void IncrementalPathfinder::expand(std::vector<int>* visited, std::vector<int>* frontier) {
+    int u = open.top();
+    open.remove(u);
+    ++expanded;
+
+    if (g[u] > rhs[u]) {
+        // Overconsistent: its cost is now final, so propagate it
+        g[u] = rhs[u];
+        if (visited) visited->push_back(u);
+        // u's g only went down, so a neighbour's rhs can only drop to the value through u
+        for (const Edge& e : graph[u].neighbors) {
+            float via = g[u] + e.cost;
+            if (e.to == startIndex || via >= rhs[e.to]) continue;
+            rhs[e.to] = via;
+            open.set(e.to, keyOf(e.to));
+            if (frontier) frontier->push_back(e.to);
+        }
+        return;
+    }
+
+    // Underconsistent: a cost went up, so invalidate u and re-derive it and its neighbours
+    g[u] = INF;
+    updateVertex(u, frontier);
+    for (const Edge& e : graph[u].neighbors) updateVertex(e.to, frontier);
+}
+
+bool IncrementalPathfinder::step(SearchState& state) {
+    state.frontier.clear();
+    if (finished()) {
+        state.path = currentBestPath(goalIndex);
+        return false;
+    }
+    expand(&state.visited, &state.frontier);
+    return true;
+}
+
+std::vector<int> IncrementalPathfinder::run() {
+    while (!finished()) expand(nullptr, nullptr);
+    return currentBestPath(goalIndex);
+}
+
+void IncrementalPathfinder::edgesChanged(const std::vector<EdgeChange>& changes) {
+    for (const EdgeChange& c : changes) {
+        updateVertex(c.from, nullptr);
+        updateVertex(c.to, nullptr);
+    }
+}
+
+std::vector<int> IncrementalPathfinder::currentBestPath(int target) const {
+    if (g[target] == INF) return {};
+
+    // Walk back along the neighbour that explains g; the node count bounds the walk
+    std::vector<int> path = {target};
+    int v = target;
+    while (v != startIndex && path.size() <= graph.size()) {
+        int next = parentOf(v);
+        if (next < 0) return {};
+        path.push_back(next);
+        v = next;
+    }
+    if (v != startIndex) return {};
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// The neighbour that explains g[v]; there are no stored parents
+int IncrementalPathfinder::parentOf(int v) const {
+    if (v == startIndex) return -1;
+    int next = -1;
+    float best = INF;
+    for (const Edge& e : graph[v].neighbors) {
+        float via = g[e.to] + e.cost;
+        if (via < best) { best = via; next = e.to; }
+    }
+    return next;
+}
@@ -0,0 +1,47 @@
+#include "input.h"
+
+void InputQueue::install(GLFWwindow* window) {
+    glfwSetWindowUserPointer(window, this);
+    glfwSetKeyCallback(window, [](GLFWwindow* w, int key, int, int action, int) {
+        static_cast<InputQueue*>(glfwGetWindowUserPointer(w))->key(key, action);
+    });
+    glfwSetCursorPosCallback(window, [](GLFWwindow* w, double x, double y) {
+        static_cast<InputQueue*>(glfwGetWindowUserPointer(w))->cursor(x, y);
+    });
+    glfwSetScrollCallback(window, [](GLFWwindow* w, double, double dy) {
+        static_cast<InputQueue*>(glfwGetWindowUserPointer(w))->scroll(dy);
+    });
+}
+
+void InputQueue::key(int key, int action) {
+    if (key < 0 || key > GLFW_KEY_LAST || action == GLFW_REPEAT) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    state.down[key] = action == GLFW_PRESS;
+    if (action == GLFW_PRESS && state.presses[key] < 255) ++state.presses[key];
+}
+
+void InputQueue::cursor(double x, double y) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (firstCursor) {
+        lastX = x;
+        lastY = y;
+        firstCursor = false;
+    }
+    state.look += glm::vec2(static_cast<float>(x - lastX), static_cast<float>(lastY - y));
+    lastX = x;
+    lastY = y;
+}
+
+void InputQueue::scroll(double dy) {
+    std::lock_guard<std::mutex> lock(mutex);
+    state.scroll += static_cast<float>(dy);
+}
+
+InputState InputQueue::take() {
+    std::lock_guard<std::mutex> lock(mutex);
+    InputState taken = state;
+    state.presses.fill(0);
+    state.look = glm::vec2(0.0f);
+    state.scroll = 0.0f;
+    return taken;
+}
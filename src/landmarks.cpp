@@ -0,0 +1,54 @@
+#include "landmarks.h"
+#include "parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+LandmarkTable::LandmarkTable(const std::vector<Node>& g, int count, int threads)
+    : count(std::max(1, std::min(count, static_cast<int>(g.size()))))
+{
+    auto t0 = std::chrono::steady_clock::now();
+    const int V = static_cast<int>(g.size());
+
+    // Farthest-point selection over horizontal positions: start from the node
+    // farthest from the centroid, then keep adding the node farthest from all
+    // landmarks so far. Edge costs grow with distance, so this spreads the
+    // landmarks around the map edge where their bounds are tightest.
+    glm::vec2 centroid(0.0f);
+    for (const Node& n : g) centroid += glm::vec2(n.position.x, n.position.z);
+    centroid /= static_cast<float>(V);
+
+    std::vector<float> nearest(V);
+    for (int v = 0; v < V; ++v) {
+        nearest[v] = glm::length(glm::vec2(g[v].position.x, g[v].position.z) - centroid);
+    }
+    for (int l = 0; l < this->count; ++l) {
+        int pick = static_cast<int>(std::max_element(nearest.begin(), nearest.end()) - nearest.begin());
+        chosen.push_back(pick);
+        glm::vec2 p(g[pick].position.x, g[pick].position.z);
+        for (int v = 0; v < V; ++v) {
+            float d = glm::length(glm::vec2(g[v].position.x, g[v].position.z) - p);
+            nearest[v] = l == 0 ? d : std::min(nearest[v], d);
+        }
+    }
+
+    // One Dijkstra per landmark, then interleave so a node's bounds are contiguous
+    std::vector<std::vector<float>> tables(this->count);
+    parallelFor(this->count, [&](int l, int) {
+        tables[l] = shortestDistances(g, chosen[l]);
+    }, threads);
+
+    dist.resize(static_cast<size_t>(V) * this->count);
+    parallelFor(V, [&](int v, int) {
+        for (int l = 0; l < this->count; ++l) dist[static_cast<size_t>(v) * this->count + l] = tables[l][v];
+    }, threads, 4096);
+
+    buildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+std::vector<int> findPathALT(const std::vector<Node>& graph, const LandmarkTable& landmarks,
+                             int startIndex, int goalIndex, SearchWorkspace& ws) {
+    return findPathWithHeuristic(graph, startIndex, goalIndex, ws, ws.openSet, [&](int v) {
+        return landmarks.lowerBound(v, goalIndex);
+    });
+}
\ No newline at end of file
@@ -1,10 +1,11 @@
 #include "lighting.h"
-#include <glad/glad.h>
-#include <glm/gtc/type_ptr.hpp>
+#include <cmath>
+#include "horizon.h"
 
-void setLightUniforms(unsigned int shaderProgram,
-                      const glm::vec3& lightPos,
+void setLightUniforms(FrameUniforms& frame,
+                      const glm::vec3& toSun,
                       const glm::vec3& viewPos) {
-    glUniform3fv(glGetUniformLocation(shaderProgram, "lightPos"), 1, glm::value_ptr(lightPos));
-    glUniform3fv(glGetUniformLocation(shaderProgram, "viewPos"), 1, glm::value_ptr(viewPos));
-}
\ No newline at end of file
+    frame.viewPos = glm::vec4(viewPos, 1.0f);
+    frame.lightDir = glm::vec4(-toSun, std::asin(glm::clamp(toSun.y, -1.0f, 1.0f)));
+    HorizonMap::sunWeights(toSun, &frame.sunWeights[0].x);
+}
@@ -6,126 +6,39 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
 
 #include "shader.h"
-#include "camera.h"
+#include "shader_library.h"
 #include "terrain.h"
 #include "lighting.h"
 #include "pathfinding.h"
+#include "landmarks.h"
+#include "flow_field.h"
+#include "async_search.h"
+#include "alternatives.h"
+#include "peaks.h"
+#include "viewshed.h"
+#include "hydrology.h"
+#include "contours.h"
+#include "horizon.h"
+#include "gpu_buffers.h"
+#include "edge_attributes.h"
+#include "simulation.h"
+#include "camera_path.h"
+#include "frame_timer.h"
+#include "headless.h"
 
 // Window size
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-// Terrain shaders
-const char* vertexShaderSource = R"(
-#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-
-out vec3 FragPos;
-out vec3 Normal;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
-    gl_Position = projection * view * vec4(FragPos, 1.0);
-}
-)";
-
-const char* fragmentShaderSource = R"(
-#version 330 core
-in vec3 FragPos;
-in vec3 Normal;
-
-out vec4 FragColor;
-
-uniform vec3 viewPos;
-uniform float maxHeight;
-uniform vec3 lightDir;
-
-void main() {
-    vec3 norm = normalize(Normal);
-    float diff = max(dot(norm, lightDir), 0.0);
-
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(lightDir, norm);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 8);
-    vec3 specular = vec3(0.03) * spec;
-
-    float h = clamp(FragPos.y / maxHeight, 0.0, 1.0);
-    vec3 lowColor  = vec3(0.25, 0.25, 0.45);
-    vec3 midColor  = vec3(0.35, 0.75, 0.35);
-    vec3 highColor = vec3(0.85, 0.85, 0.85);
-
-    vec3 baseColor = mix(lowColor, midColor, smoothstep(0.001, 0.05, h));
-    baseColor = mix(baseColor, highColor, smoothstep(0.6, 1.0, h));
-
-    vec3 rockColor = vec3(0.5, 0.5, 0.5);
-    float slope = clamp(norm.y, 0.0, 1.0);
-    float rockFactor = 1.0 - slope;
-    baseColor = mix(baseColor, rockColor, 0.3 * rockFactor);
-
-    float ambientStrength = 0.25;
-    vec3 ambient = ambientStrength * baseColor;
-    vec3 diffuse = 0.8 * diff * baseColor;
-
-    vec3 result = ambient + diffuse + specular;
-    FragColor = vec4(result, 1.0);
-}
-)";
-
-// Path shaders
-const char* pathVertexShader = R"(
-#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
-
-out vec3 vColor;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-void main() {
-    vColor = aColor;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-}
-)";
-
-const char* pathFragmentShader = R"(
-#version 330 core
-in vec3 vColor;
-out vec4 FragColor;
-
-void main() {
-    FragColor = vec4(vColor, 1.0);
-}
-)";
-
-const char* pointVertexShader = R"(
-#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
-out vec3 vColor;
-uniform mat4 model, view, projection;
-void main() {
-    vColor = aColor;
-    gl_Position = projection * view * model * vec4(aPos,1.0);
-}
-)";
-
-const char* pointFragmentShader = R"(
-#version 330 core
-in vec3 vColor;
-out vec4 FragColor;
-void main() { FragColor = vec4(vColor,1.0); }
-)";
-
+// GLSL lives in shaders/ (next to the sources), reloaded while running when edited
+#ifndef PEAKGEN_SHADER_DIR
+#define PEAKGEN_SHADER_DIR "shaders"
+#endif
 
 // Helper to upload points (visited/frontier)
 unsigned int uploadPoints(const std::vector<int>& indices, const std::vector<Node>& graph, const glm::vec3& color) {
@@ -149,44 +62,96 @@ unsigned int uploadPoints(const std::vector<int>& indices, const std::vector<Nod
     return vao;
 }
 
-int main() {
-    // Init GLFW
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "PeakGen Terrain + Path", NULL, NULL);
-    if (!window) {
-        std::cerr << "Couldn't create GLFW window\n";
-        glfwTerminate();
-        return -1;
-    }
-    glfwMakeContextCurrent(window);
+int main(int argc, char** argv) {
+    // --headless replays a camera flight offscreen and reports frame times (see headless.h)
+    HeadlessOptions headless;
+    if (!headless.parse(argc, argv)) return -1;
+    OffscreenContext offscreen;
+    GLFWwindow* window = nullptr;
+
+    if (headless.enabled) {
+        if (!offscreen.create(headless.width, headless.height)) return -1;
+        if (!gladLoadGLLoader(offscreen.loader())) {
+            std::cerr << "Couldn't initialize GLAD\n";
+            return -1;
+        }
+        if (!offscreen.createFramebuffer()) return -1;
+    } else {
+        // Init GLFW
+        glfwInit();
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "PeakGen Terrain + Path", NULL, NULL);
+        if (!window) {
+            std::cerr << "Couldn't create GLFW window\n";
+            glfwTerminate();
+            return -1;
+        }
+        glfwMakeContextCurrent(window);
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cerr << "Couldn't initialize GLAD\n";
-        return -1;
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+            std::cerr << "Couldn't initialize GLAD\n";
+            return -1;
+        }
+
+        glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int w, int h){ glViewport(0,0,w,h); });
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     }
 
     glEnable(GL_DEPTH_TEST);
 
-    glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int w, int h){ glViewport(0,0,w,h); });
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-    // Compile shaders
-    unsigned int terrainProgram = compileShader(vertexShaderSource, fragmentShaderSource);
-    unsigned int pathProgram    = compileShader(pathVertexShader, pathFragmentShader);
+    // Load shaders, from the binary cache when the sources and driver are unchanged
+    ShaderLibrary shaders(PEAKGEN_SHADER_DIR, "shader_cache");
+    ShaderProgram& terrainProgram = shaders.load("terrain", "terrain.vert", "terrain.frag");
+    ShaderProgram& pathProgram = shaders.load("path", "path.vert", "path.frag");
 
     // Point shader for visited/frontier dots
-    unsigned int pointProgram   = compileShader(pointVertexShader, pointFragmentShader);
+    ShaderProgram& pointProgram = shaders.load("point", "point.vert", "point.frag");
+    ShaderProgram& nodePointProgram = shaders.load("node_point", "node_point.vert", "point.frag");
+    if (!terrainProgram.valid() || !pathProgram.valid() || !pointProgram.valid() || !nodePointProgram.valid()) {
+        if (window) glfwTerminate();
+        return -1;
+    }
+    std::cout << "Shaders: " << shaders.loadMs() << " ms, " << shaders.cacheHits() << " of "
+              << shaders.cacheHits() + shaders.cacheMisses() << " from cache\n";
+
+    // Edited shader files are recompiled on a hidden window's context, sharing objects with this one
+    GLFWwindow* shaderContext = nullptr;
+    if (window) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        shaderContext = glfwCreateWindow(1, 1, "", NULL, window);
+        if (shaderContext) shaders.watch(shaderContext);
+    }
 
-    // Generate terrain ---------------------------------------------------
+    // Generate terrain (a fixed seed when headless, so every run draws the same map) ---
     std::vector<float> vertices;
     std::vector<unsigned int> indices;
-    float maxHeight = generateTerrain(30, vertices, indices); // grid size
+    float maxHeight = headless.enabled ? generateTerrain(headless.grid, vertices, indices, headless.seed)
+                                       : generateTerrain(30, vertices, indices); // grid size
+
+    // Camera and light go through the Frame uniform block, written once per frame;
+    // what is fixed for the whole run is set here once, and again after a reload
+    FrameUniformBuffer frameUniforms;
+    const glm::mat4 model = glm::mat4(1.0f);
+    GLint showViewshedLocation = -1, showRiversLocation = -1, pointColorLocation = -1;
+    auto setFixedUniforms = [&]() {
+        for (const ShaderProgram* program : {&terrainProgram, &pathProgram, &pointProgram, &nodePointProgram}) {
+            program->use();
+            glUniformMatrix4fv(program->uniform("model"), 1, GL_FALSE, glm::value_ptr(model));
+        }
+        terrainProgram.use();
+        glUniformMatrix3fv(terrainProgram.uniform("normalMatrix"), 1, GL_FALSE,
+                           glm::value_ptr(glm::mat3(glm::transpose(glm::inverse(model)))));
+        glUniform1f(terrainProgram.uniform("maxHeight"), maxHeight);
+        showViewshedLocation = terrainProgram.uniform("showViewshed");
+        showRiversLocation = terrainProgram.uniform("showRivers");
+        pointColorLocation = nodePointProgram.uniform("color");
+        nodePointProgram.use();
+        glUniform1f(nodePointProgram.uniform("lift"), 0.02f);
+    };
+    setFixedUniforms();
 
     std::vector<float> normals;
     computeNormals(vertices, indices, normals);
@@ -219,6 +184,15 @@ int main() {
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
+
+    // Viewshed mask: one byte per vertex in its own buffer, read as a normalised float
+    unsigned int viewshedVBO;
+    glGenBuffers(1, &viewshedVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, viewshedVBO);
+    std::vector<uint8_t> hiddenMask(vertices.size() / 3, 0);   // the simulation sends only what changes
+    glBufferData(GL_ARRAY_BUFFER, hiddenMask.size(), hiddenMask.data(), GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(2, 1, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)0);
+    glEnableVertexAttribArray(2);
     glBindVertexArray(0);
 
     // Convert vertices to glm::vec3
@@ -231,193 +205,387 @@ int main() {
     // Pathfinding setup
     auto graph = buildGraph(positions, indices);
 
-    // Strict tallest by y (object-space)
-    int peakIndex = 0;
-    float maxY = positions[0].y;
+    // Drainage network: rivers drawn on the terrain (toggled with B) and kept out of routes
+    HeightGrid heightGrid(positions);
+    DrainageNetwork drainage = analyzeDrainage(heightGrid);
+    std::vector<float> channels = channelStrength(drainage.accumulation,
+                                                  std::max<uint32_t>(8, (uint32_t)(positions.size() / 200)));
+    EdgeAttributes edgeAttributes(graph);
+    edgeAttributes.setWetness(channels);
+    CostProfile avoidChannels;
+    avoidChannels.channel = 50.0f;
+    std::vector<float> routeCosts;
+    edgeAttributes.evaluate(avoidChannels, routeCosts);
+    applyCosts(graph, edgeAttributes, routeCosts);
+
+    // Horizon angles for shadows and ambient occlusion: 16 bytes per vertex as four vec4s, plus open sky
+    HorizonMap horizons(heightGrid);
+    std::cout << "Horizons baked in " << horizons.lastMs() << " ms\n";
+    unsigned int horizonVBO, skyVBO;
+    glGenBuffers(1, &horizonVBO);
+    glGenBuffers(1, &skyVBO);
+    glBindVertexArray(terrainVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, horizonVBO);
+    glBufferData(GL_ARRAY_BUFFER, horizons.angles().size(), horizons.angles().data(), GL_STATIC_DRAW);
+    for (int k = 0; k < 4; ++k) {
+        glVertexAttribPointer(4 + k, 4, GL_UNSIGNED_BYTE, GL_TRUE, HorizonMap::DIRECTIONS, (void*)(size_t)(4 * k));
+        glEnableVertexAttribArray(4 + k);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, skyVBO);
+    glBufferData(GL_ARRAY_BUFFER, horizons.skyView().size(), horizons.skyView().data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(8, 1, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)0);
+    glEnableVertexAttribArray(8);
+    glBindVertexArray(0);
+
+    std::vector<uint8_t> channelBytes(channels.size());
+    for (size_t v = 0; v < channels.size(); ++v) {
+        channelBytes[v] = static_cast<uint8_t>(std::lround(channels[v] * 255.0f));
+    }
+    unsigned int channelVBO;
+    glGenBuffers(1, &channelVBO);
+    glBindVertexArray(terrainVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, channelVBO);
+    glBufferData(GL_ARRAY_BUFFER, channelBytes.size(), channelBytes.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(3, 1, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)0);
+    glEnableVertexAttribArray(3);
+    glBindVertexArray(0);
 
-    for (int i = 1; i < (int)positions.size(); ++i) {
-        if (positions[i].y > maxY) {
-            maxY = positions[i].y;
-            peakIndex = i;
-        }
+    // Most prominent peaks; the first is the highest point and the route goal
+    std::vector<Peak> peaks = findPeaks(positions, indices, 8);
+    int peakIndex = peaks[0].vertex;
+    for (const Peak& p : peaks) {
+        std::cout << "Peak " << p.vertex << ": height " << p.height << ", prominence " << p.prominence << "\n";
     }
+    std::vector<float> peakMarkerData = buildPeakMarkerData(positions, peaks);
 
     int startIndex = 0; // could be lowest corner
-    Pathfinder pf(graph, startIndex, peakIndex);
-    SearchState state;
+
+    // Landmark (ALT) bounds keep the search optimal without a heuristic weight
+    LandmarkTable landmarks(graph);
+    Pathfinder pf(graph, startIndex, peakIndex, landmarks);
+
+    // The search runs at full speed on its own thread; the simulation only
+    // replays the expansions it published, at a playback rate of its own
+    AsyncSearch search(pf);
+
+    // Every route ends at the peak, so one reverse search answers all starts
+    FlowField flowField(graph, peakIndex);
+    std::vector<float> heatmapData = buildHeatmapVertexData(graph, flowField);
+
+    // What the summit sees, toggled with V; hold G to move the observer to the camera
+    Viewshed viewshed(positions);
+
+    // Up to three alternatives to the shortest route, toggled with R
+    AlternativeRouter alternativeRouter(graph);
+    auto alternatives = alternativeRouter.find(startIndex, peakIndex);
+    std::vector<float> alternativesData;
+    for (size_t r = 0; r < alternatives.size(); ++r) {
+        const RouteStats& st = alternatives[r].stats;
+        std::cout << "Route " << r << ": cost " << st.cost << " (x" << alternatives[r].stretch << "), length "
+                  << st.length << ", climb " << st.climb << ", mean slope " << st.meanSlope
+                  << ", max slope " << st.maxSlope << "\n";
+        if (r == 0) continue; // the search draws the shortest one
+        auto data = buildPathVertexData(graph, alternatives[r].path);
+        alternativesData.insert(alternativesData.end(), data.begin(), data.end());
+    }
 
     glLineWidth(3.0f);
 
-    // Path line VAO/VBO (persistent)
-    unsigned int pathVAO, pathVBO;
+    // Path line VAO (persistent): [x y z r g b] per segment end, rewritten only
+    // from where a new best path leaves the one already drawn
+    AppendBuffer pathLine;
+    unsigned int pathVAO;
     glGenVertexArrays(1, &pathVAO);
-    glGenBuffers(1, &pathVBO);
 
     glBindVertexArray(pathVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, pathVBO);
-    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, pathLine.id());
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
     glBindVertexArray(0);
 
-    // Visited points VAO/VBO (persistent)
-    unsigned int visitedVAO, visitedVBO;
+    // Visited and frontier points: node ids only, positions come from the terrain VBO.
+    // Visited ids are appended as the playback reaches them, never re-sent.
+    AppendBuffer visitedIds(graph.size() * sizeof(int));
+    AppendBuffer frontierIds;
+    unsigned int visitedVAO, frontierVAO;
     glGenVertexArrays(1, &visitedVAO);
-    glGenBuffers(1, &visitedVBO);
-
-    glBindVertexArray(visitedVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, visitedVBO);
-    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+    glGenVertexArrays(1, &frontierVAO);
+    auto bindNodeIds = [&](unsigned int vao, const AppendBuffer& ids) {
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, terrainVBO);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ids.id());
+        glBindVertexArray(0);
+    };
+    bindNodeIds(visitedVAO, visitedIds);
+    bindNodeIds(frontierVAO, frontierIds);
+
+    // Cost-to-peak heatmap VAO/VBO (static, toggled with H)
+    unsigned int heatmapVAO, heatmapVBO;
+    glGenVertexArrays(1, &heatmapVAO);
+    glGenBuffers(1, &heatmapVBO);
+
+    glBindVertexArray(heatmapVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, heatmapVBO);
+    glBufferData(GL_ARRAY_BUFFER, heatmapData.size() * sizeof(float), heatmapData.data(), GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
     glBindVertexArray(0);
 
-    // Frontier points VAO/VBO (persistent)
-    unsigned int frontierVAO, frontierVBO;
-    glGenVertexArrays(1, &frontierVAO);
-    glGenBuffers(1, &frontierVBO);
+    // Contour lines VAO/VBO (toggled with C, - and = halve/double the interval)
+    ContourMap contours(heightGrid, 0.05f);
+    unsigned int contoursVAO, contoursVBO;
+    glGenVertexArrays(1, &contoursVAO);
+    glGenBuffers(1, &contoursVBO);
 
-    glBindVertexArray(frontierVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, frontierVBO);
-    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+    glBindVertexArray(contoursVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, contoursVBO);
+    glBufferData(GL_ARRAY_BUFFER, contours.vertexData().size() * sizeof(float), contours.vertexData().data(),
+                 GL_DYNAMIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
     glBindVertexArray(0);
 
-    // Render loop
-    float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    // Alternative routes VAO/VBO (static, toggled with R)
+    unsigned int alternativesVAO, alternativesVBO;
+    glGenVertexArrays(1, &alternativesVAO);
+    glGenBuffers(1, &alternativesVBO);
+
+    glBindVertexArray(alternativesVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, alternativesVBO);
+    glBufferData(GL_ARRAY_BUFFER, alternativesData.size() * sizeof(float), alternativesData.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
 
-    while (!glfwWindowShouldClose(window)) {
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+    // Peak markers VAO/VBO (static)
+    unsigned int peaksVAO, peaksVBO;
+    glGenVertexArrays(1, &peaksVAO);
+    glGenBuffers(1, &peaksVBO);
 
-        processInput(window, deltaTime);
+    glBindVertexArray(peaksVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, peaksVBO);
+    glBufferData(GL_ARRAY_BUFFER, peakMarkerData.size() * sizeof(float), peakMarkerData.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
 
+    // Input, camera, playback and overlay updates run on the simulation; the render
+    // thread only uploads what each packet changed and draws
+    float aspect = headless.enabled ? (float)headless.width / (float)headless.height
+                                    : (float)SCR_WIDTH / (float)SCR_HEIGHT;
+    Simulation simulation(graph, search, viewshed, contours, peakIndex, aspect);
+    bool wireframe = false;
+    auto applyPacket = [&](const FramePacket& packet) {
+        if (!packet.visitedAdded.empty()) {
+            visitedIds.append(packet.visitedAdded.data(), packet.visitedAdded.size() * sizeof(int));
+        }
+        if (packet.frontierChanged) {
+            frontierIds.clear();
+            frontierIds.append(packet.frontier.data(), packet.frontier.size() * sizeof(int));
+        }
+        if (packet.pathChanged) {
+            pathLine.truncate(packet.pathKept * 12 * sizeof(float));
+            pathLine.append(packet.pathTail.data(), packet.pathTail.size() * sizeof(float));
+        }
+        if (packet.viewshedChanged) {
+            glBindBuffer(GL_ARRAY_BUFFER, viewshedVBO);
+            glBufferSubData(GL_ARRAY_BUFFER, packet.viewshedFirst, packet.viewshedBytes.size(),
+                            packet.viewshedBytes.data());
+        }
+        if (packet.contoursChanged) {
+            glBindBuffer(GL_ARRAY_BUFFER, contoursVBO);
+            glBufferData(GL_ARRAY_BUFFER, packet.contourData.size() * sizeof(float), packet.contourData.data(),
+                         GL_DYNAMIC_DRAW);
+        }
+        // Wireframe with F: show mesh as lines, or solid triangles
+        if (packet.wireframe != wireframe) {
+            wireframe = packet.wireframe;
+            glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
+        }
+    };
+    auto drawFrame = [&](const FramePacket& packet) {
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glm::mat4 model = glm::mat4(1.0f);
-        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
-        glm::mat4 projection = glm::perspective(glm::radians(fov),
-                                                (float)SCR_WIDTH / (float)SCR_HEIGHT,
-                                                0.1f, 100.0f);
+        // Camera and sun for every program, in one upload
+        FrameUniforms frame;
+        frame.view = packet.view;
+        frame.projection = packet.projection;
+        setLightUniforms(frame, packet.toSun, packet.viewPos);
+        frameUniforms.update(frame);
+        if (shaders.applyReloads() > 0) setFixedUniforms();
 
         // Draw terrain
-        glUseProgram(terrainProgram);
-        glUniformMatrix4fv(glGetUniformLocation(terrainProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniformMatrix4fv(glGetUniformLocation(terrainProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(glGetUniformLocation(terrainProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
-        glm::vec3 lightDir = glm::normalize(glm::vec3(-0.3f, -1.0f, -0.2f));
-        glUniform3fv(glGetUniformLocation(terrainProgram, "lightDir"), 1, glm::value_ptr(lightDir));
-        glUniform3fv(glGetUniformLocation(terrainProgram, "viewPos"), 1, glm::value_ptr(cameraPos));
-        glUniform1f(glGetUniformLocation(terrainProgram, "maxHeight"), maxHeight);
+        terrainProgram.use();
+        glUniform1i(showViewshedLocation, packet.showViewshed);
+        glUniform1i(showRiversLocation, packet.showRivers);
 
         glBindVertexArray(terrainVAO);
         glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
         glBindVertexArray(0);
 
-        // Advance search one step and stop if path is found
-        static double lastStepTime = 0.0;
-        double now = glfwGetTime();
-
-        // Only keep stepping if the path hasn't been found yet
-        if (state.path.empty()) {
-            if (now - lastStepTime > 0.1) {
-                pf.step(state);
-                lastStepTime = now;
-            }
+        // Draw cost-to-peak heatmap
+        if (packet.showHeatmap) {
+            glPointSize(6.0f);
+            pointProgram.use();
+            glBindVertexArray(heatmapVAO);
+            glDrawArrays(GL_POINTS, 0, (GLsizei)(heatmapData.size() / 6));
+            glBindVertexArray(0);
         }
 
-        // Draw visited nodes (blue, smaller)
-        if (!state.visited.empty()) {
-            std::vector<float> data;
-            for (int idx : state.visited) {
-                const glm::vec3& p = graph[idx].position;
-                data.insert(data.end(), {p.x, p.y+0.02f, p.z, 0.2f, 0.2f, 0.9f});
-            }
+        // Draw peak markers
+        glPointSize(16.0f);
+        pointProgram.use();
+        glBindVertexArray(peaksVAO);
+        glDrawArrays(GL_POINTS, 0, (GLsizei)(peakMarkerData.size() / 6));
+        glBindVertexArray(0);
 
+        // Draw visited nodes (blue, smaller)
+        nodePointProgram.use();
+        if (packet.visitedShown > 0) {
             glPointSize(8.0f);
+            glUniform3f(pointColorLocation, 0.2f, 0.2f, 0.9f);
             glBindVertexArray(visitedVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, visitedVBO);
-            glBufferData(GL_ARRAY_BUFFER, data.size()*sizeof(float), data.data(), GL_DYNAMIC_DRAW);
-
-            glUseProgram(pointProgram);
-            glUniformMatrix4fv(glGetUniformLocation(pointProgram,"model"),1,GL_FALSE,glm::value_ptr(model));
-            glUniformMatrix4fv(glGetUniformLocation(pointProgram,"view"),1,GL_FALSE,glm::value_ptr(view));
-            glUniformMatrix4fv(glGetUniformLocation(pointProgram,"projection"),1,GL_FALSE,glm::value_ptr(projection));
-
-            glDrawArrays(GL_POINTS, 0, (GLsizei)state.visited.size());
+            glDrawElements(GL_POINTS, (GLsizei)packet.visitedShown, GL_UNSIGNED_INT, (void*)0);
             glBindVertexArray(0);
         }
 
         // Draw frontier nodes (orange, bigger)
-        if (!state.frontier.empty()) {
-            std::vector<float> data;
-            for (int idx : state.frontier) {
-                const glm::vec3& p = graph[idx].position;
-                data.insert(data.end(), {p.x, p.y+0.02f, p.z, 0.9f, 0.5f, 0.1f});
-            }
-
+        if (packet.showFrontier && frontierIds.size() > 0) {
             glPointSize(12.0f);
+            glUniform3f(pointColorLocation, 0.9f, 0.5f, 0.1f);
             glBindVertexArray(frontierVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, frontierVBO);
-            glBufferData(GL_ARRAY_BUFFER, data.size()*sizeof(float), data.data(), GL_DYNAMIC_DRAW);
-
-            glUseProgram(pointProgram);
-            glUniformMatrix4fv(glGetUniformLocation(pointProgram,"model"),1,GL_FALSE,glm::value_ptr(model));
-            glUniformMatrix4fv(glGetUniformLocation(pointProgram,"view"),1,GL_FALSE,glm::value_ptr(view));
-            glUniformMatrix4fv(glGetUniformLocation(pointProgram,"projection"),1,GL_FALSE,glm::value_ptr(projection));
+            glDrawElements(GL_POINTS, (GLsizei)(frontierIds.size() / sizeof(int)), GL_UNSIGNED_INT, (void*)0);
+            glBindVertexArray(0);
+        }
 
-            glDrawArrays(GL_POINTS, 0, (GLsizei)state.frontier.size());
+        // Draw the best path the search has published (final once it finishes)
+        if (pathLine.size() > 0) {
+            pathProgram.use();
+            glBindVertexArray(pathVAO);
+            glDrawArrays(GL_LINES, 0, (GLsizei)(pathLine.size() / (6 * sizeof(float))));
             glBindVertexArray(0);
         }
 
-        // Draw current best path (progressive line)
-        int target = state.visited.empty() ? startIndex : state.visited.back();
-        auto partialPath = pf.currentBestPath(target);
-        if (!partialPath.empty()) {
-            auto pathVertexData = buildPathVertexData(graph, partialPath);
+        // Draw the contour lines
+        if (packet.showContours && packet.contourSegments > 0) {
+            glLineWidth(1.0f);
+            pathProgram.use();
+            glBindVertexArray(contoursVAO);
+            glDrawArrays(GL_LINES, 0, (GLsizei)(packet.contourSegments * 2));
+            glBindVertexArray(0);
+            glLineWidth(3.0f);
+        }
 
-            glBindVertexArray(pathVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, pathVBO);
-            glBufferData(GL_ARRAY_BUFFER,
-                        pathVertexData.size() * sizeof(float),
-                        pathVertexData.data(),
-                        GL_DYNAMIC_DRAW);
-
-            glUseProgram(pathProgram);
-            glUniformMatrix4fv(glGetUniformLocation(pathProgram,"model"),1,GL_FALSE,glm::value_ptr(model));
-            glUniformMatrix4fv(glGetUniformLocation(pathProgram,"view"),1,GL_FALSE,glm::value_ptr(view));
-            glUniformMatrix4fv(glGetUniformLocation(pathProgram,"projection"),1,GL_FALSE,glm::value_ptr(projection));
-
-            glDrawArrays(GL_LINES, 0, (GLsizei)pathVertexData.size()/6);
+        // Draw the alternative routes (thinner than the main one)
+        if (packet.showAlternatives && !alternativesData.empty()) {
+            glLineWidth(1.5f);
+            pathProgram.use();
+            glBindVertexArray(alternativesVAO);
+            glDrawArrays(GL_LINES, 0, (GLsizei)(alternativesData.size() / 6));
             glBindVertexArray(0);
+            glLineWidth(3.0f);
+        }
+    };
+
+    if (headless.enabled) {
+        // Reproducible replay: the search is run to the end first and the simulation
+        // is stepped here at a fixed 60 fps, so every run draws the same frames
+        search.wait();
+        const float step = 1.0f / 60.0f;
+        glm::vec2 extent = heightGrid.spacing * glm::vec2((float)(heightGrid.side - 1));
+        glm::vec3 center(heightGrid.origin.x + 0.5f * extent.x, 0.5f * maxHeight, heightGrid.origin.y + 0.5f * extent.y);
+        CameraPath flight = CameraPath::orbit(center, 0.9f * std::max(extent.x, extent.y), std::max(maxHeight, 0.5f),
+                                              headless.frames * step);
+        if (!headless.dumpDir.empty()) std::filesystem::create_directories(headless.dumpDir);
+
+        FrameTimer timer;
+        std::vector<uint8_t> pixels;
+        for (int f = -headless.warmup; f < headless.frames; ++f) {
+            simulation.step(step, flight.at(std::max(f, 0) * step));
+            timer.begin();
+            if (simulation.takeFrame()) applyPacket(simulation.frame());
+            drawFrame(simulation.frame());
+            timer.end(f >= 0, true);
+            if (f >= 0 && !headless.dumpDir.empty() && f % headless.dumpEvery == 0) {
+                offscreen.readPixels(pixels);
+                char name[32];
+                std::snprintf(name, sizeof(name), "frame_%05d.ppm", f);
+                writePPM((std::filesystem::path(headless.dumpDir) / name).string(), headless.width,
+                         headless.height, pixels);
+            }
+        }
+        timer.finish();
+
+        std::printf("headless: %d frames (+%d warm-up) at %dx%d, %d^2 grid, seed %u, %s, %s\n", headless.frames,
+                    headless.warmup, headless.width, headless.height, heightGrid.side, headless.seed,
+                    offscreen.description().c_str(), reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+        // cpu: submitting the frame; gpu: timer queries; frame: until glFinish returns
+        const char* names[3] = {"cpu  ", "gpu  ", "frame"};
+        FrameTimer::Summary times[3] = {timer.cpu(), timer.gpu(), timer.synced()};
+        for (int k = 0; k < 3; ++k) {
+            std::printf("  %s mean %.3f p50 %.3f p90 %.3f p99 %.3f max %.3f ms\n", names[k], times[k].meanMs,
+                        times[k].p50Ms, times[k].p90Ms, times[k].p99Ms, times[k].maxMs);
+        }
+        timer.release();
+    } else {
+        simulation.input().install(window);
+        simulation.start();
+
+        // Render loop
+        while (!glfwWindowShouldClose(window)) {
+            // Newest packet from the simulation; when none arrived since the last frame, draw the same one again
+            if (simulation.takeFrame()) applyPacket(simulation.frame());
+            drawFrame(simulation.frame());
+            glfwSwapBuffers(window);
+            glfwPollEvents();
         }
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        simulation.stop();
     }
 
     glDeleteVertexArrays(1, &terrainVAO);
     glDeleteBuffers(1, &terrainVBO);
     glDeleteBuffers(1, &terrainEBO);
+    glDeleteBuffers(1, &viewshedVBO);
+    glDeleteBuffers(1, &channelVBO);
+    glDeleteBuffers(1, &horizonVBO);
+    glDeleteBuffers(1, &skyVBO);
 
     glDeleteVertexArrays(1, &pathVAO);
-    glDeleteBuffers(1, &pathVBO);
+    pathLine.release();
+
+    glDeleteVertexArrays(1, &heatmapVAO);
+    glDeleteBuffers(1, &heatmapVBO);
+
+    glDeleteVertexArrays(1, &contoursVAO);
+    glDeleteBuffers(1, &contoursVBO);
+    glDeleteVertexArrays(1, &alternativesVAO);
+    glDeleteBuffers(1, &alternativesVBO);
+    glDeleteVertexArrays(1, &peaksVAO);
+    glDeleteBuffers(1, &peaksVBO);
 
     glDeleteVertexArrays(1, &visitedVAO);
-    glDeleteBuffers(1, &visitedVBO);
     glDeleteVertexArrays(1, &frontierVAO);
-    glDeleteBuffers(1, &frontierVBO);
+    visitedIds.release();
+    frontierIds.release();
+
+    shaders.release();
+    frameUniforms.release();
+    if (shaderContext) glfwDestroyWindow(shaderContext);
 
-    glfwTerminate();
+    if (window) glfwTerminate();
+    offscreen.release();
     return 0;
 }
\ No newline at end of file
@@ -1,94 +1,133 @@
 #include "pathfinding.h"
-#include <queue>
+#include "landmarks.h"
 #include <limits>
 #include <cmath>
 #include <algorithm>
 #include <functional>
-#include <queue>
-#include <unordered_set>
 #include <glm/glm.hpp>
 
 // Compute slope-based cost between two vertices
-static float edgeCost(const glm::vec3& a, const glm::vec3& b) {
-    float dy = std::abs(b.y - a.y);
-    float dxz = glm::length(glm::vec2(b.x - a.x, b.z - a.z));
-    float slope = dxz > 0.0f ? dy / dxz : 0.0f;
-    return 1.0f + slope * 2.0f; // factor controls steepness penalty
+float edgeCost(const glm::vec3& a, const glm::vec3& b) {
+    return SlopeCost()(a, b); // penalty factor controls steepness penalty
 }
 
 std::vector<Node> buildGraph(const std::vector<glm::vec3>& vertices,
                              const std::vector<unsigned int>& indices) {
-    std::vector<Node> graph(vertices.size());
-    for (size_t i = 0; i < vertices.size(); ++i) {
-        graph[i].position = vertices[i];
-    }
-
-    // Each triangle gives 3 edges
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        int a = indices[i], b = indices[i+1], c = indices[i+2];
-        float ab = edgeCost(vertices[a], vertices[b]);
-        float bc = edgeCost(vertices[b], vertices[c]);
-        float ca = edgeCost(vertices[c], vertices[a]);
-
-        graph[a].neighbors.push_back({b, ab});
-        graph[b].neighbors.push_back({a, ab});
-
-        graph[b].neighbors.push_back({c, bc});
-        graph[c].neighbors.push_back({b, bc});
+    return buildGraph(vertices, indices, SlopeCost());
+}
 
-        graph[c].neighbors.push_back({a, ca});
-        graph[a].neighbors.push_back({c, ca});
+float maxHorizontalStep(const std::vector<Node>& graph) {
+    float longest = 0.0f;
+    for (const Node& n : graph) {
+        for (const Edge& e : n.neighbors) {
+            longest = std::max(longest, horizontalDistance(n.position, graph[e.to].position));
+        }
     }
-    return graph;
+    return longest;
 }
 
-std::vector<int> findPath(const std::vector<Node>& graph,
-                          int startIndex,
-                          int goalIndex) {
-    const float INF = std::numeric_limits<float>::infinity();
-    std::vector<float> dist(graph.size(), INF);
-    std::vector<int> prev(graph.size(), -1);
+std::vector<EdgeChange> setNodeHeight(std::vector<Node>& graph, int v, float y) {
+    std::vector<EdgeChange> changes;
+    graph[v].position.y = y;
+    for (Edge& e : graph[v].neighbors) {
+        float cost = edgeCost(graph[v].position, graph[e.to].position);
+        if (cost == e.cost) continue;
+        e.cost = cost;
+        changes.push_back({v, e.to});
+        for (Edge& back : graph[e.to].neighbors) {
+            if (back.to == v && back.cost != cost) {
+                back.cost = cost;
+                changes.push_back({e.to, v});
+            }
+        }
+    }
+    return changes;
+}
 
-    struct Entry {
-        int idx;
-        float f;
-        bool operator>(const Entry& other) const { return f > other.f; }
-    };
-    auto heuristic = [&](const glm::vec3& a, const glm::vec3& b) {
-        return glm::length(a - b);
-    };
+float pathCost(const std::vector<Node>& graph, const std::vector<int>& path) {
+    float total = 0.0f;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        float best = std::numeric_limits<float>::infinity();
+        for (const Edge& e : graph[path[i]].neighbors) {
+            if (e.to == path[i+1]) best = std::min(best, e.cost);
+        }
+        total += best;
+    }
+    return total;
+}
 
-    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> openSet;
+float heuristicScale(const std::vector<Node>& graph) {
+    float scale = std::numeric_limits<float>::infinity();
+    for (const Node& n : graph) {
+        for (const Edge& e : n.neighbors) {
+            float len = glm::length(graph[e.to].position - n.position);
+            if (len > 0.0f) scale = std::min(scale, e.cost / len);
+        }
+    }
+    // Shave off a little so float rounding can't make the bound inconsistent
+    return std::isfinite(scale) ? scale * 0.999f : 0.0f;
+}
 
-    dist[startIndex] = 0.0f;
-    float h0 = heuristic(graph[startIndex].position, graph[goalIndex].position);
-    openSet.push({startIndex, h0});
+std::vector<float> shortestDistances(const std::vector<Node>& graph, int source) {
+    std::vector<float> dist(graph.size(), std::numeric_limits<float>::infinity());
+    QuaternaryHeapOpenSet openSet;
+    openSet.reset(graph.size());
 
+    dist[source] = 0.0f;
+    openSet.push(source, 0.0f);
     while (!openSet.empty()) {
-        auto current = openSet.top(); openSet.pop();
-        int u = current.idx;
-        if (u == goalIndex) break;
-
+        int u = openSet.pop();
+        float du = dist[u];
         for (const Edge& e : graph[u].neighbors) {
-            float tentative_g = dist[u] + e.cost;
+            float tentative_g = du + e.cost;
             if (tentative_g < dist[e.to]) {
                 dist[e.to] = tentative_g;
-                prev[e.to] = u;
-                float h = heuristic(graph[e.to].position, graph[goalIndex].position);
-                float f = tentative_g + h * 15.0f; // more heuristic weight
-                openSet.push({e.to, f});
+                openSet.push(e.to, tentative_g);
             }
         }
     }
+    return dist;
+}
+
+void SearchWorkspace::beginQuery(size_t nodeCount) {
+    if (stamp.size() < nodeCount) {
+        distance.resize(nodeCount);
+        parent.resize(nodeCount);
+        stamp.resize(nodeCount, 0);
+        closedStamp.resize(nodeCount, 0);
+    }
+
+    // Stamp 0 means "never touched"; on wrap-around clear the stamps once
+    if (++generation == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0u);
+        std::fill(closedStamp.begin(), closedStamp.end(), 0u);
+        generation = 1;
+    }
+}
 
+std::vector<int> SearchWorkspace::pathTo(int target) const {
     std::vector<int> path;
-    for (int v = goalIndex; v != -1; v = prev[v]) {
+    for (int v = target; v != -1; v = prev(v)) {
         path.push_back(v);
     }
     std::reverse(path.begin(), path.end());
     return path;
 }
 
+std::vector<int> findPath(const std::vector<Node>& graph,
+                          int startIndex,
+                          int goalIndex) {
+    SearchWorkspace ws;
+    return findPath(graph, startIndex, goalIndex, ws);
+}
+
+std::vector<int> findPath(const std::vector<Node>& graph,
+                          int startIndex,
+                          int goalIndex,
+                          SearchWorkspace& ws) {
+    return findPathWith(graph, startIndex, goalIndex, ws, ws.openSet);
+}
+
 // Map slope to color: green (easy), yellow (moderate), red (hard)
 static glm::vec3 slopeColor(float slope) {
     if (slope < 0.2f) return glm::vec3(0.1f, 0.9f, 0.1f);        // easy: green
@@ -100,16 +139,10 @@ std::vector<float> buildPathVertexData(const std::vector<Node>& graph, const std
     std::vector<float> pathVertexData; // [x y z r g b] per vertex
     pathVertexData.reserve(path.size() * 12); // two vertices per segment
 
-    auto computeSlope = [&](const glm::vec3& a, const glm::vec3& b) {
-        float dy = std::abs(b.y - a.y);
-        float dxz = glm::length(glm::vec2(b.x - a.x, b.z - a.z));
-        return dxz > 0.0f ? dy / dxz : 0.0f;
-    };
-
     for (size_t i = 0; i + 1 < path.size(); ++i) {
         const glm::vec3& a = graph[path[i]].position;
         const glm::vec3& b = graph[path[i+1]].position;
-        float s = computeSlope(a, b);
+        float s = slopeBetween(a, b);
         glm::vec3 c = slopeColor(s);
 
         // Vertex A
@@ -125,47 +158,58 @@ std::vector<float> buildPathVertexData(const std::vector<Node>& graph, const std
 
 // Pathfinder A* version (used to be djikstra)
 Pathfinder::Pathfinder(const std::vector<Node>& g, int s, int goal)
-    : graph(g), startIndex(s), goalIndex(goal),
-      dist(g.size(), std::numeric_limits<float>::infinity()),
-      prev(g.size(), -1)
+    : graph(g), startIndex(s), goalIndex(goal), ws(&ownWorkspace)
+{
+    start();
+}
+
+Pathfinder::Pathfinder(const std::vector<Node>& g, int s, int goal, SearchWorkspace& workspace)
+    : graph(g), startIndex(s), goalIndex(goal), ws(&workspace)
+{
+    start();
+}
+
+Pathfinder::Pathfinder(const std::vector<Node>& g, int s, int goal, const LandmarkTable& landmarks)
+    : graph(g), startIndex(s), goalIndex(goal), ws(&ownWorkspace), landmarks(&landmarks)
 {
-    dist[startIndex] = 0.0f;
-    float h = heuristic(graph[startIndex].position, graph[goalIndex].position);
-    openSet.push({startIndex, h});
+    start();
+}
+
+void Pathfinder::start() {
+    ws->beginQuery(graph.size());
+    ws->openSet.reset(graph.size());
+    ws->set(startIndex, 0.0f, -1);
+    ws->openSet.push(startIndex, estimate(startIndex));
 }
 
 bool Pathfinder::step(SearchState& state) {
-    if (openSet.empty()) return false;
+    if (ws->openSet.empty()) return false;
 
-    auto currentEntry = openSet.top();
-    openSet.pop();
-    int u = currentEntry.idx;
+    int u = ws->openSet.pop();
 
     // If already visited, skip
-    if (visitedSet.count(u)) return true;
-    visitedSet.insert(u);
+    if (ws->isClosed(u)) return true;
+    ws->close(u);
 
     state.visited.push_back(u);
 
     if (u == goalIndex) {
         // reconstruct path
-        state.path.clear();
-        for (int v = goalIndex; v != -1; v = prev[v]) state.path.push_back(v);
-        std::reverse(state.path.begin(), state.path.end());
+        state.path = ws->pathTo(goalIndex);
 
         state.frontier.clear();
         return false; // search done
     }
 
     state.frontier.clear();
+    float du = ws->dist(u);
     for (const Edge& e : graph[u].neighbors) {
-        float tentative_g = dist[u] + e.cost;
-        if (tentative_g < dist[e.to]) {
-            dist[e.to] = tentative_g;
-            prev[e.to] = u;
-            float h = heuristic(graph[e.to].position, graph[goalIndex].position);
-            float f = tentative_g + h * 15.0f;
-            openSet.push({e.to, f});
+        float tentative_g = du + e.cost;
+        if (tentative_g < ws->dist(e.to)) {
+            ws->set(e.to, tentative_g, u);
+            if (ws->isClosed(e.to)) continue;
+            float f = tentative_g + estimate(e.to);
+            ws->openSet.push(e.to, f);
             state.frontier.push_back(e.to);
         }
     }
@@ -173,12 +217,12 @@ bool Pathfinder::step(SearchState& state) {
 }
 
 std::vector<int> Pathfinder::currentBestPath(int target) const {
-    std::vector<int> path;
-    for (int v = target; v != -1; v = prev[v]) {
-        path.push_back(v);
-    }
-    std::reverse(path.begin(), path.end());
-    return path;
+    return ws->pathTo(target);
+}
+
+float Pathfinder::estimate(int v) const {
+    if (landmarks) return landmarks->lowerBound(v, goalIndex);
+    return heuristic(graph[v].position, graph[goalIndex].position) * 15.0f;
 }
 
 float Pathfinder::heuristic(const glm::vec3& a, const glm::vec3& b) {
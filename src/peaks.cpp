@@ -0,0 +1,130 @@
+#include "peaks.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include "parallel.h"
+
+namespace {
+
+// Vertex adjacency from the triangle list in compressed rows; shared edges appear
+// twice, which the sweep doesn't mind
+struct MeshAdjacency {
+    std::vector<int> first;   // vertex -> first neighbour, plus a final end entry
+    std::vector<int> neighbors;
+
+    MeshAdjacency(size_t vertexCount, const std::vector<unsigned int>& indices) {
+        first.assign(vertexCount + 1, 0);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) first[indices[i + k] + 1] += 2;
+        }
+        for (size_t v = 0; v < vertexCount; ++v) first[v + 1] += first[v];
+
+        std::vector<int> fill(first.begin(), first.end() - 1);
+        neighbors.resize(first.back());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                int a = indices[i + k], b = indices[i + (k + 1) % 3];
+                neighbors[fill[a]++] = b;
+                neighbors[fill[b]++] = a;
+            }
+        }
+    }
+};
+
+// Sort key: heights mapped to unsigned integers in descending order in the high
+// half, vertex in the low half, so one integer compare gives "higher first,
+// then lower index"
+uint64_t sweepKey(float height, int vertex) {
+    uint32_t bits;
+    std::memcpy(&bits, &height, sizeof bits);
+    bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;   // float order as unsigned order
+    return (static_cast<uint64_t>(~bits) << 32) | static_cast<uint32_t>(vertex);
+}
+
+int findRoot(std::vector<int>& parent, int v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]]; // path halving
+        v = parent[v];
+    }
+    return v;
+}
+
+} // namespace
+
+std::vector<Peak> findPeaks(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+                            size_t topK, int threads) {
+    const int n = static_cast<int>(positions.size());
+    std::vector<Peak> peaks;
+    if (n == 0) return peaks;
+
+    MeshAdjacency adjacency(positions.size(), indices);
+
+    // Highest first; ties by vertex index so "higher" is a strict order
+    std::vector<uint64_t> order(n);
+    parallelFor(n, [&](int v, int) { order[v] = sweepKey(positions[v].y, v); }, threads, 1 << 14);
+    parallelSort(order.begin(), order.end(), std::less<uint64_t>(), threads);
+
+    std::vector<int> parent(n, -1);     // -1 until swept
+    std::vector<int> islandPeak(n, -1); // per root: index into peaks of the island's peak
+    std::vector<int> touching;
+    for (uint64_t key : order) {
+        int v = static_cast<int>(key & 0xffffffffu);
+        float height = positions[v].y;
+        parent[v] = v;
+
+        touching.clear();
+        for (int k = adjacency.first[v]; k < adjacency.first[v + 1]; ++k) {
+            int u = adjacency.neighbors[k];
+            if (parent[u] == -1) continue;
+            int root = findRoot(parent, u);
+            if (std::find(touching.begin(), touching.end(), root) == touching.end()) touching.push_back(root);
+        }
+
+        if (touching.empty()) {
+            // Nothing around is higher: a new peak
+            islandPeak[v] = static_cast<int>(peaks.size());
+            peaks.push_back({v, height, 0.0f, -1});
+            continue;
+        }
+
+        // Peaks were created highest first, so the lowest index is the highest peak
+        int keep = touching[0];
+        for (int root : touching) {
+            if (islandPeak[root] < islandPeak[keep]) keep = root;
+        }
+        for (int root : touching) {
+            if (root == keep) continue;
+            Peak& lower = peaks[islandPeak[root]];
+            lower.keySaddle = v;
+            lower.prominence = lower.height - height;
+            parent[root] = keep;
+        }
+        parent[v] = keep;
+    }
+
+    // Peaks never absorbed are the highest of their connected piece of mesh
+    float lowest = positions[order.back() & 0xffffffffu].y;
+    for (Peak& p : peaks) {
+        if (p.keySaddle == -1) p.prominence = p.height - lowest;
+    }
+
+    std::sort(peaks.begin(), peaks.end(), [](const Peak& a, const Peak& b) {
+        return a.prominence != b.prominence ? a.prominence > b.prominence : a.vertex < b.vertex;
+    });
+    if (topK > 0 && peaks.size() > topK) peaks.resize(topK);
+    return peaks;
+}
+
+std::vector<float> buildPeakMarkerData(const std::vector<glm::vec3>& positions, const std::vector<Peak>& peaks) {
+    std::vector<float> data;
+    data.reserve(peaks.size() * 6);
+    float top = peaks.empty() ? 0.0f : peaks.front().prominence;
+    for (const Peak& p : peaks) {
+        float t = top > 0.0f ? p.prominence / top : 0.0f;
+        glm::vec3 color = glm::mix(glm::vec3(0.45f, 0.1f, 0.45f), glm::vec3(1.0f, 0.3f, 1.0f), t);
+        const glm::vec3& pos = positions[p.vertex];
+        data.insert(data.end(), {pos.x, pos.y + 0.03f, pos.z, color.r, color.g, color.b});
+    }
+    return data;
+}
@@ -0,0 +1,65 @@
+#include "query_engine.h"
+#include "landmarks.h"
+#include "parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+RouteQueryEngine::RouteQueryEngine(const std::vector<Node>& g, int threads)
+    : graph(g), threads(threads > 0 ? threads : hardwareThreads())
+{
+    hScale = heuristicScale(graph);
+    workspaces.resize(this->threads);
+}
+
+RouteQueryEngine::RouteQueryEngine(const std::vector<Node>& g, const LandmarkTable& landmarks, int threads)
+    : RouteQueryEngine(g, threads)
+{
+    this->landmarks = &landmarks;
+}
+
+void RouteQueryEngine::answer(const RouteQuery& q, SearchWorkspace& ws, RouteResult& out) const {
+    auto t0 = std::chrono::steady_clock::now();
+    if (landmarks) {
+        out.path = findPathALT(graph, *landmarks, q.start, q.goal, ws);
+    } else {
+        out.path = findPathWith(graph, q.start, q.goal, ws, ws.openSet, hScale);
+    }
+    out.cost = ws.isClosed(q.goal) ? ws.dist(q.goal) : std::numeric_limits<float>::infinity();
+    if (out.cost == std::numeric_limits<float>::infinity()) out.path.clear();
+    out.latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+std::vector<RouteResult> RouteQueryEngine::run(const std::vector<RouteQuery>& queries, BatchStats* stats) {
+    std::vector<RouteResult> results(queries.size());
+
+    auto t0 = std::chrono::steady_clock::now();
+    // Query costs vary by orders of magnitude, so hand them out one at a time
+    parallelFor(static_cast<int>(queries.size()), [&](int i, int w) {
+        answer(queries[i], workspaces[w], results[i]);
+    }, threads);
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    if (stats) {
+        *stats = BatchStats();
+        stats->queries = queries.size();
+        stats->threads = threads;
+        stats->wallMs = wallMs;
+        stats->queriesPerSecond = wallMs > 0.0 ? queries.size() * 1000.0 / wallMs : 0.0;
+
+        std::vector<double> latencies;
+        latencies.reserve(results.size());
+        for (const RouteResult& r : results) latencies.push_back(r.latencyMs);
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p) {
+            if (latencies.empty()) return 0.0;
+            size_t rank = static_cast<size_t>(p * (latencies.size() - 1) + 0.5);
+            return latencies[rank];
+        };
+        stats->p50Ms = percentile(0.50);
+        stats->p90Ms = percentile(0.90);
+        stats->p99Ms = percentile(0.99);
+        stats->maxMs = percentile(1.0);
+    }
+    return results;
+}
@@ -1,26 +1,131 @@
 #include "shader.h"
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
-unsigned int compileShader(const char* vertexSrc, const char* fragmentSrc) {
-    // Compile vertex shader
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexSrc, nullptr);
-    glCompileShader(vertexShader);
+// Compile one stage; returns 0 (after printing the log) if it doesn't compile
+static unsigned int compileStage(GLenum type, const char* source) {
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
 
-    // Compile fragment shader
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentSrc, nullptr);
-    glCompileShader(fragmentShader);
+    int ok = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        int length = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::string log(std::max(length, 1), '\0');
+        glGetShaderInfoLog(shader, length, nullptr, &log[0]);
+        std::cerr << (type == GL_VERTEX_SHADER ? "Vertex" : "Fragment") << " shader failed to compile:\n" << log << "\n";
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+unsigned int compileShader(const char* vertexSrc, const char* fragmentSrc, bool retrievable) {
+    unsigned int vertexShader = compileStage(GL_VERTEX_SHADER, vertexSrc);
+    unsigned int fragmentShader = compileStage(GL_FRAGMENT_SHADER, fragmentSrc);
+    if (vertexShader == 0 || fragmentShader == 0) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
 
     // Link program
     unsigned int shaderProgram = glCreateProgram();
     glAttachShader(shaderProgram, vertexShader);
     glAttachShader(shaderProgram, fragmentShader);
+    if (retrievable) glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(shaderProgram);
 
     // Cleanup
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
 
+    int ok = 0;
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        int length = 0;
+        glGetProgramiv(shaderProgram, GL_INFO_LOG_LENGTH, &length);
+        std::string log(std::max(length, 1), '\0');
+        glGetProgramInfoLog(shaderProgram, length, nullptr, &log[0]);
+        std::cerr << "Shader program failed to link:\n" << log << "\n";
+        glDeleteProgram(shaderProgram);
+        return 0;
+    }
     return shaderProgram;
-}
\ No newline at end of file
+}
+
+ShaderProgram::ShaderProgram(const char* vertexSrc, const char* fragmentSrc)
+    : program(compileShader(vertexSrc, fragmentSrc))
+{
+    reflect();
+}
+
+ShaderProgram::ShaderProgram(unsigned int linkedProgram)
+    : program(linkedProgram)
+{
+    reflect();
+}
+
+void ShaderProgram::reset(unsigned int linkedProgram) {
+    release();
+    program = linkedProgram;
+    reflect();
+}
+
+void ShaderProgram::reflect() {
+    locations.clear();
+    if (program == 0) return;
+
+    // Every active uniform outside a block; "name[0]" is also reachable as "name"
+    int count = 0, longest = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &longest);
+    std::vector<char> name(std::max(longest, 1));
+    for (int u = 0; u < count; ++u) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, u, (GLsizei)name.size(), &length, &size, &type, name.data());
+        std::string uniformName(name.data(), length);
+        GLint location = glGetUniformLocation(program, uniformName.c_str());
+        if (location < 0) continue;   // member of a uniform block
+        locations[uniformName] = location;
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0) {
+            locations[uniformName.substr(0, uniformName.size() - 3)] = location;
+        }
+    }
+
+    GLuint frame = glGetUniformBlockIndex(program, "Frame");
+    if (frame != GL_INVALID_INDEX) glUniformBlockBinding(program, frame, FRAME_BINDING);
+}
+
+void ShaderProgram::release() {
+    if (program != 0) glDeleteProgram(program);
+    program = 0;
+    locations.clear();
+}
+
+GLint ShaderProgram::uniform(const std::string& name) const {
+    auto it = locations.find(name);
+    return it != locations.end() ? it->second : -1;
+}
+
+FrameUniformBuffer::FrameUniformBuffer() {
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BINDING, buffer);
+}
+
+void FrameUniformBuffer::update(const FrameUniforms& frame) {
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame);
+}
+
+void FrameUniformBuffer::release() {
+    if (buffer != 0) glDeleteBuffers(1, &buffer);
+    buffer = 0;
+}
@@ -0,0 +1,281 @@
+#include "shader_library.h"
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+static const int MAX_INCLUDE_DEPTH = 8;
+
+// FNV-1a, 64 bit
+static uint64_t hashString(const std::string& s, uint64_t h = 14695981039346656037ull) {
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+ShaderLibrary::ShaderLibrary(std::string shaderDir, std::string cacheDir)
+    : shaderDir(std::move(shaderDir)), cacheDir(std::move(cacheDir))
+{
+    for (GLenum e : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const GLubyte* s = glGetString(e);
+        if (s) driver += reinterpret_cast<const char*>(s);
+        driver += '\n';
+    }
+    if (GLAD_GL_VERSION_4_1) {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        binariesSupported = formats > 0;
+    }
+}
+
+// Inline #include "file" lines. Each file gets its own GLSL source-string number
+// (its index in files), set with #line, so compile errors point at the right file
+// and line; a failed build prints which number is which. Each file's write time is
+// taken before it is read, into newest, so an edit made during the read is seen later.
+bool ShaderLibrary::preprocess(const std::string& file, std::string& out, std::vector<std::string>& files,
+                               fs::file_time_type& newest, int depth) const {
+    if (depth > MAX_INCLUDE_DEPTH) {
+        std::cerr << "Shader includes nested too deep at " << file << "\n";
+        return false;
+    }
+    std::string path = (fs::path(shaderDir) / file).string();
+    std::error_code ec;
+    fs::file_time_type written = fs::last_write_time(path, ec);
+    if (!ec && written > newest) newest = written;
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Can't read shader " << path << "\n";
+        return false;
+    }
+    const size_t number = files.size();
+    files.push_back(path);
+
+    std::string line;
+    for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+        size_t at = line.find_first_not_of(" \t");
+        if (at != std::string::npos && line.compare(at, 8, "#include") == 0) {
+            size_t open = line.find('"', at), close = open == std::string::npos ? open : line.find('"', open + 1);
+            if (close == std::string::npos) {
+                std::cerr << path << ":" << lineNo << ": malformed #include\n";
+                return false;
+            }
+            out += "#line 1 " + std::to_string(files.size()) + "\n";
+            if (!preprocess(line.substr(open + 1, close - open - 1), out, files, newest, depth + 1)) return false;
+            out += "#line " + std::to_string(lineNo + 1) + " " + std::to_string(number) + "\n";
+            continue;
+        }
+        out += line;
+        out += '\n';
+    }
+    return true;
+}
+
+bool ShaderLibrary::readSources(const Entry& entry, Sources& out) const {
+    out = Sources();
+    return preprocess(entry.vertexFile, out.vertex, out.files, out.newest, 0) &&
+           preprocess(entry.fragmentFile, out.fragment, out.files, out.newest, 0);
+}
+
+fs::file_time_type ShaderLibrary::newestWrite(const std::vector<std::string>& files) const {
+    fs::file_time_type newest = fs::file_time_type::min();
+    for (const std::string& file : files) {
+        std::error_code ec;
+        fs::file_time_type t = fs::last_write_time(file, ec);
+        if (!ec && t > newest) newest = t;
+    }
+    return newest;
+}
+
+std::string ShaderLibrary::cachePath(const std::string& name, const Sources& sources) const {
+    uint64_t key = hashString(driver, hashString(sources.fragment, hashString(sources.vertex) ^ 0x9e3779b97f4a7c15ull));
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key));
+    return (fs::path(cacheDir) / (name + "-" + hex + ".bin")).string();
+}
+
+// Cache file: the binary format (uint32) followed by the binary
+unsigned int ShaderLibrary::loadBinary(const std::string& path) const {
+    std::ifstream in(path, std::ios::binary);
+    uint32_t format = 0;
+    if (!in || !in.read(reinterpret_cast<char*>(&format), sizeof(format))) return 0;
+    std::vector<char> binary((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (binary.empty()) return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {   // the driver may refuse binaries from another build of itself
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// Written under a temporary name and renamed, so a crash never leaves half a binary;
+// binaries of the program's older sources are removed.
+void ShaderLibrary::saveBinary(unsigned int program, const std::string& name, const std::string& path) const {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+    std::error_code ec;
+    fs::create_directories(cacheDir, ec);
+    const std::string current = fs::path(path).filename().string();
+    for (const fs::directory_entry& file : fs::directory_iterator(cacheDir, ec)) {
+        std::string f = file.path().filename().string();
+        if (f != current && f.size() == current.size() && f.compare(0, name.size() + 1, name + "-") == 0 &&
+            f.compare(f.size() - 4, 4, ".bin") == 0) {
+            fs::remove(file.path(), ec);
+        }
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        uint32_t stored = format;
+        out.write(reinterpret_cast<const char*>(&stored), sizeof(stored));
+        out.write(binary.data(), binary.size());
+        if (!out) return;
+    }
+    fs::rename(temporary, path, ec);
+}
+
+unsigned int ShaderLibrary::build(const Entry& entry, Sources& sources, bool& fromCache) const {
+    fromCache = false;
+    if (!readSources(entry, sources)) return 0;
+    std::string path;
+    if (binariesSupported) {
+        path = cachePath(entry.name, sources);
+        if (unsigned int program = loadBinary(path)) {
+            fromCache = true;
+            return program;
+        }
+    }
+    unsigned int program = compileShader(sources.vertex.c_str(), sources.fragment.c_str(), binariesSupported);
+    if (program == 0) {
+        std::cerr << "in " << entry.name << ", source strings:";
+        for (size_t f = 0; f < sources.files.size(); ++f) std::cerr << " " << f << " = " << sources.files[f];
+        std::cerr << "\n";
+        return 0;
+    }
+    if (binariesSupported) saveBinary(program, entry.name, path);
+    return program;
+}
+
+ShaderProgram& ShaderLibrary::load(const std::string& name, const std::string& vertexFile,
+                                   const std::string& fragmentFile) {
+    auto t0 = std::chrono::steady_clock::now();
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->vertexFile = vertexFile;
+    entry->fragmentFile = fragmentFile;
+
+    Sources sources;
+    bool fromCache = false;
+    entry->program = std::make_unique<ShaderProgram>(build(*entry, sources, fromCache));
+    entry->files = sources.files;
+    entry->stamp = sources.newest;
+    (fromCache ? hits : misses)++;
+
+    ShaderProgram& program = *entry->program;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        entries.push_back(std::move(entry));
+    }
+    loadTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return program;
+}
+
+void ShaderLibrary::watch(GLFWwindow* workerContext, int intervalMs) {
+    if (watcher.joinable() || !workerContext) return;
+    running = true;
+    watcher = std::thread([this, workerContext, intervalMs] {
+        glfwMakeContextCurrent(workerContext);
+        std::unique_lock<std::mutex> guard(lock);
+        while (running) {
+            wake.wait_for(guard, std::chrono::milliseconds(intervalMs), [this] { return !running; });
+            if (!running) break;
+            guard.unlock();
+            poll();
+            guard.lock();
+        }
+        guard.unlock();
+        glfwMakeContextCurrent(nullptr);
+    });
+}
+
+// Files are compared and programs compiled without holding the lock, so the render
+// thread never waits on a compile; the lock covers only reading and publishing.
+void ShaderLibrary::poll() {
+    size_t count;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        count = entries.size();
+    }
+    for (size_t e = 0; e < count && running; ++e) {
+        Entry copy;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            copy.name = entries[e]->name;
+            copy.vertexFile = entries[e]->vertexFile;
+            copy.fragmentFile = entries[e]->fragmentFile;
+            copy.files = entries[e]->files;
+            copy.stamp = entries[e]->stamp;
+        }
+        fs::file_time_type newest = newestWrite(copy.files);
+        if (newest <= copy.stamp) continue;
+
+        Sources sources;
+        bool fromCache = false;
+        unsigned int program = build(copy, sources, fromCache);
+        if (program) glFinish();   // complete before the render context uses it
+
+        std::lock_guard<std::mutex> guard(lock);
+        // Stamped even on failure, so a broken edit is reported once, not every poll. The
+        // times are the ones taken before reading, so a save during the build rebuilds again.
+        if (!sources.files.empty()) entries[e]->files = sources.files;
+        entries[e]->stamp = std::max(newest, sources.newest);
+        if (program) ready.push_back({e, program});
+    }
+}
+
+int ShaderLibrary::applyReloads() {
+    std::vector<Reload> swaps;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        swaps.swap(ready);
+    }
+    for (const Reload& r : swaps) {
+        entries[r.entry]->program->reset(r.program);
+        std::cout << "Reloaded shader " << entries[r.entry]->name << "\n";
+    }
+    return static_cast<int>(swaps.size());
+}
+
+void ShaderLibrary::stop() {
+    if (!watcher.joinable()) return;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        running = false;
+    }
+    wake.notify_all();
+    watcher.join();
+}
+
+void ShaderLibrary::release() {
+    stop();
+    for (const Reload& r : ready) glDeleteProgram(r.program);
+    ready.clear();
+    for (auto& entry : entries) entry->program->release();
+}
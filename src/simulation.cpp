@@ -0,0 +1,201 @@
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+static const size_t FLOATS_PER_SEGMENT = 12;   // two [x y z r g b] ends
+
+void FramePacket::clearChanges() {
+    visitedAdded.clear();
+    frontierChanged = false;
+    frontier.clear();
+    pathChanged = false;
+    pathKept = 0;
+    pathTail.clear();
+    viewshedChanged = false;
+    viewshedFirst = 0;
+    viewshedBytes.clear();
+    contoursChanged = false;
+    contourData.clear();
+}
+
+void FramePacket::setPath(size_t kept, const std::vector<float>& tail) {
+    if (pathChanged && kept >= pathKept) {
+        // The new path still runs along part of the unseen tail; keep that part
+        pathTail.resize((kept - pathKept) * FLOATS_PER_SEGMENT);
+    } else {
+        pathKept = kept;
+        pathTail.clear();
+    }
+    pathTail.insert(pathTail.end(), tail.begin(), tail.end());
+    pathChanged = true;
+}
+
+Simulation::Simulation(const std::vector<Node>& graph, AsyncSearch& search, Viewshed& viewshed,
+                       ContourMap& contours, int peakIndex, float aspect, double tickHz)
+    : graph(graph), search(search), viewshed(viewshed), contours(contours), peakIndex(peakIndex),
+      aspect(aspect), tickHz(tickHz)
+{
+    // Sun position: hold L to move it round, K switches between high and low sun
+    sunAzimuth = std::atan2(0.2f, 0.3f);
+    sunElevation = std::asin(1.0f / std::sqrt(1.13f));   // the old fixed light, (0.3, 1, 0.2) towards the sun
+    sentMask.assign(viewshed.grid().size(), 0);
+    shownParent.assign(graph.size(), -1);
+    state.showRivers = true;
+    state.contourSegments = contours.segmentCount();
+}
+
+void Simulation::start() {
+    if (worker.joinable()) return;
+    tick(0.0f);
+    running = true;
+    worker = std::thread([this] {
+        using clock = std::chrono::steady_clock;
+        const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / tickHz));
+        auto last = clock::now();
+        auto next = last + period;
+        while (running) {
+            std::this_thread::sleep_until(next);
+            auto now = clock::now();
+            tick(std::chrono::duration<float>(now - last).count());
+            last = now;
+            // A slow tick isn't made up for with a burst of short ones
+            next = std::max(next + period, clock::now());
+        }
+    });
+}
+
+void Simulation::stop() {
+    running = false;
+    if (worker.joinable()) worker.join();
+}
+
+void Simulation::step(float deltaTime, const Camera& placed) {
+    camera = placed;
+    tick(deltaTime);
+}
+
+void Simulation::tick(float deltaTime) {
+    InputState input = inputs.take();
+    camera.update(input, deltaTime);
+
+    // Toggles: F wireframe, H cost-to-peak heatmap, R alternative routes, B rivers, C contours, V viewshed
+    state.wireframe ^= input.toggled(GLFW_KEY_F);
+    state.showHeatmap ^= input.toggled(GLFW_KEY_H);
+    state.showAlternatives ^= input.toggled(GLFW_KEY_R);
+    state.showRivers ^= input.toggled(GLFW_KEY_B);
+    state.showContours ^= input.toggled(GLFW_KEY_C);
+    state.showViewshed ^= input.toggled(GLFW_KEY_V);
+
+    // Sun: L moves it round, K toggles a low sun
+    lowSun ^= input.toggled(GLFW_KEY_K);
+    if (input.held(GLFW_KEY_L)) sunAzimuth += 0.8f * deltaTime;
+    float elevation = lowSun ? 0.3f : sunElevation;
+
+    // Playback speed with [ and ]
+    if (input.pressed(GLFW_KEY_LEFT_BRACKET)) playbackRate = std::max(1.0, playbackRate * 0.5);
+    if (input.pressed(GLFW_KEY_RIGHT_BRACKET)) playbackRate = std::min(1e7, playbackRate * 2.0);
+
+    // The renderer hasn't taken the last packet: add to it rather than lose its changes
+    bool reclaimed = packets.reclaim();
+    FramePacket& packet = packets.back();
+    if (!reclaimed) packet.clearChanges();
+
+    packet.tick = ++ticks;
+    packet.view = camera.view();
+    packet.projection = camera.projection(aspect);
+    packet.viewPos = camera.position;
+    packet.toSun = glm::vec3(std::cos(elevation) * std::cos(sunAzimuth), std::sin(elevation),
+                             std::cos(elevation) * std::sin(sunAzimuth));
+    packet.wireframe = state.wireframe;
+    packet.showHeatmap = state.showHeatmap;
+    packet.showAlternatives = state.showAlternatives;
+    packet.showRivers = state.showRivers;
+    packet.showContours = state.showContours;
+    packet.showViewshed = state.showViewshed;
+
+    // Contour interval: - halves it, = doubles it
+    bool finer = input.pressed(GLFW_KEY_MINUS), coarser = input.pressed(GLFW_KEY_EQUAL);
+    if (finer || coarser) {
+        float interval = std::clamp(contours.interval() * (finer ? 0.5f : 2.0f), 0.005f, 0.4f);
+        contours.setInterval(interval);
+        packet.contoursChanged = true;
+        packet.contourData = contours.vertexData();
+        state.contourSegments = contours.segmentCount();
+        std::cout << "Contour interval " << interval << ": " << state.contourSegments << " segments in "
+                  << contours.lastMs() << " ms\n";
+    }
+    packet.contourSegments = state.contourSegments;
+
+    // Observer at the summit, or under the camera while G is held; recompute when it moves.
+    // Only the bytes that differ from the mask already sent go out.
+    if (state.showViewshed) {
+        int observer = input.held(GLFW_KEY_G) ? viewshed.nearestVertex(camera.position.x, camera.position.z)
+                                              : peakIndex;
+        if (observer != viewshedObserver) {
+            const std::vector<uint8_t>& mask = viewshed.compute(observer);
+            size_t first = 0, end = mask.size();
+            while (first < end && mask[first] == sentMask[first]) ++first;
+            while (end > first && mask[end - 1] == sentMask[end - 1]) --end;
+            if (first < end) {
+                if (packet.viewshedChanged) {
+                    end = std::max(end, packet.viewshedFirst + packet.viewshedBytes.size());
+                    first = std::min(first, packet.viewshedFirst);
+                }
+                packet.viewshedChanged = true;
+                packet.viewshedFirst = first;
+                packet.viewshedBytes.assign(mask.begin() + first, mask.begin() + end);
+                std::copy(mask.begin() + first, mask.begin() + end, sentMask.begin() + first);
+            }
+            viewshedObserver = observer;
+        }
+    }
+
+    // Pick up whatever the search thread published and advance the playback
+    bool published = search.poll(searchUpdate);
+    playhead = std::min(playhead + playbackRate * deltaTime, (double)searchUpdate.visited.size());
+    size_t shown = static_cast<size_t>(playhead);
+    bool advanced = shown > visitedSent;
+    if (advanced) {
+        packet.visitedAdded.insert(packet.visitedAdded.end(), searchUpdate.visited.begin() + visitedSent,
+                                   searchUpdate.visited.begin() + shown);
+        for (size_t k = visitedSent; k < shown; ++k) shownParent[searchUpdate.visited[k]] = searchUpdate.parents[k];
+        visitedSent = shown;
+    }
+    packet.visitedShown = shown;
+
+    // The frontier belongs to the latest step, so it's only drawn once playback catches up
+    if (published) {
+        packet.frontierChanged = true;
+        packet.frontier = searchUpdate.frontier;
+    }
+    packet.showFrontier = shown == searchUpdate.visited.size() && !searchUpdate.frontier.empty();
+
+    // Best path: the route to the expansion the playhead has reached, as the search
+    // saw it then; the final route only once playback has caught up with the end
+    std::vector<int> best;
+    bool caughtUp = searchUpdate.finished && shown == searchUpdate.visited.size();
+    if (caughtUp) {
+        if (published || advanced) best = searchUpdate.bestPath;
+    } else if (advanced) {
+        // Parents always come from earlier expansions, so the chain is complete;
+        // the node count bounds it in case a re-expansion left a loop
+        for (int v = searchUpdate.visited[shown - 1]; v != -1 && best.size() <= graph.size(); v = shownParent[v]) {
+            best.push_back(v);
+        }
+        std::reverse(best.begin(), best.end());
+    }
+
+    // Segments up to where it leaves the path already sent are kept; only the new tail is built
+    if (!best.empty() && best != drawnPath) {
+        size_t same = 0;
+        while (same < best.size() && same < drawnPath.size() && best[same] == drawnPath[same]) ++same;
+        size_t keptSegments = same > 0 ? same - 1 : 0;
+        std::vector<int> tail(best.begin() + keptSegments, best.end());
+        packet.setPath(keptSegments, buildPathVertexData(graph, tail));
+        drawnPath = best;
+    }
+
+    packets.publish();
+}
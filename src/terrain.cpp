@@ -9,15 +9,18 @@
 
 // Generate terrain with a mountain peak in the center
 float generateTerrain(int N, std::vector<float>& vertices, std::vector<unsigned int>& indices) {
-    vertices.clear();
-    indices.clear();
-
     // Random Perlin Noise
     // Good Map: 2022053872
 
     std::random_device rd;
-    uint32_t seed = rd();
-    siv::PerlinNoise perlin(seed); // replace with 'seed' for random
+    return generateTerrain(N, vertices, indices, rd());
+}
+
+float generateTerrain(int N, std::vector<float>& vertices, std::vector<unsigned int>& indices, uint32_t seed) {
+    vertices.clear();
+    indices.clear();
+
+    siv::PerlinNoise perlin(seed);
 
     std::cout<< "Perlin Seed: " << seed << std::endl;
 
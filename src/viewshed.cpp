@@ -0,0 +1,80 @@
+#include "viewshed.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include "parallel.h"
+
+Viewshed::Viewshed(const std::vector<glm::vec3>& positions, int threads)
+    : terrain(positions), threads(threads)
+{
+    visible.assign(positions.size(), 0);
+}
+
+// Octant: bit 0 = major axis is j, bit 1 = major direction negative, bit 2 = minor direction negative.
+// A cell at ring r, offset k (0 <= k <= r) is r steps along the major axis and k along the minor.
+// Cells on octant boundaries are swept by both neighbours but written by one:
+// the major axis (k = 0) by the positive-minor octant, the diagonal (k = r) by the i-major one.
+size_t Viewshed::sweepOctant(int octant, int oi, int oj, float eye, float targetHeight) {
+    const int side = terrain.side;
+    const float spacing = terrain.spacing;
+    const std::vector<float>& heights = terrain.heights;
+    bool majorJ = octant & 1;
+    int majorSign = (octant & 2) ? -1 : 1, minorSign = (octant & 4) ? -1 : 1;
+    int stepMajor = majorJ ? majorSign : majorSign * side;
+    int stepMinor = majorJ ? minorSign * side : minorSign;
+    int majorPos = majorJ ? oj : oi, minorPos = majorJ ? oi : oj;
+    int ringCount = majorSign > 0 ? side - 1 - majorPos : majorPos;
+    int minorLimit = minorSign > 0 ? side - 1 - minorPos : minorPos;
+    int firstOwned = minorSign > 0 ? 0 : 1;
+    bool ownsDiagonal = !majorJ;
+
+    std::vector<float> prev(std::min(ringCount, minorLimit) + 2), cur(prev.size());
+    const int observer = oi * side + oj;
+    size_t count = 0;
+    for (int r = 1; r <= ringCount; ++r) {
+        int last = std::min(r, minorLimit);
+        int prevLast = std::min(r - 1, minorLimit);
+        int rowStart = observer + r * stepMajor;
+        for (int k = 0; k <= last; ++k) {
+            int v = rowStart + k * stepMinor;
+            float invDist = 1.0f / (spacing * std::sqrt(float(r * r + k * k)));
+            float slope = (heights[v] - eye) * invDist;
+
+            // Sight-line slope where this cell's ray crosses the previous ring
+            float horizon = -std::numeric_limits<float>::infinity();
+            if (r > 1) {
+                int scaled = k * (r - 1);
+                int k0 = scaled / r;
+                float t = float(scaled - k0 * r) / float(r);
+                horizon = k0 + 1 <= prevLast ? prev[k0] + t * (prev[k0 + 1] - prev[k0]) : prev[k0];
+            }
+            cur[k] = std::max(slope, horizon);
+
+            bool owned = k >= firstOwned && (k < r || ownsDiagonal);
+            if (owned) {
+                bool lit = (heights[v] + targetHeight - eye) * invDist >= horizon;
+                visible[v] = lit ? 255 : 0;
+                count += lit;
+            }
+        }
+        std::swap(prev, cur);
+    }
+    return count;
+}
+
+const std::vector<uint8_t>& Viewshed::compute(int observer, float eyeHeight, float targetHeight) {
+    auto t0 = std::chrono::steady_clock::now();
+    int oi = observer / terrain.side, oj = observer % terrain.side;
+    float eye = terrain.heights[observer] + eyeHeight;
+
+    size_t counts[8] = {};
+    parallelFor(8, [&](int octant, int) { counts[octant] = sweepOctant(octant, oi, oj, eye, targetHeight); },
+                threads);
+    visible[observer] = 255;
+    seen = 1;
+    for (size_t c : counts) seen += c;
+
+    computeTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return visible;
+}